@@ -0,0 +1,130 @@
+#pragma once
+
+#include "GameObjects.h"
+#include <array>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+using namespace std;
+
+// ------------------------------------------------------------------------
+// Unit archetypes
+//
+// Everything that differs between unit types lives in these tables. Entities
+// are stored in one bucket per row and updated by kernels templated on the
+// row index, so stats are compile-time constants and the hot loops never
+// branch on type. Adding a unit type means adding a row here; the enums
+// below only name the rows that gameplay code refers to directly.
+// ------------------------------------------------------------------------
+struct DefenderArchetype {
+    const char* name;
+    const char* texturePath;
+    float cost;
+    float maxHealth;
+    float attackCooldown;
+    float attackRange;    // tiles
+    ProjectileKind projectile;
+    float damage;
+    float bulletSpeed;    // pixels per second
+    float splashRadius;   // tiles, SPLASH only
+    int pierce;           // enemies passed through, PIERCE only
+};
+
+struct EnemyArchetype {
+    const char* name;
+    const char* texturePath;
+    float speed;          // tiles per second
+    float health;
+    float attackRange;    // tiles
+    float shotDamage;
+    float shotSpeed;      // pixels per second
+};
+
+constexpr DefenderArchetype defenderArchetypes[] = {
+    // name      texture               cost    health  cooldown range  projectile              damage  speed   splash  pierce
+    { "Knight", "Assets/knight.png",  150.0f, 100.0f, 1.0f,    6.0f,  ProjectileKind::SINGLE, 150.0f, 200.0f, 0.0f,   1 },
+    { "Wizard", "Assets/wizzard.png", 200.0f, 100.0f, 1.0f,    8.0f,  ProjectileKind::SPLASH,  75.0f, 160.0f, 1.5f,   1 },
+    { "Archer", "Assets/archer.png",  250.0f, 100.0f, 1.0f,    10.0f, ProjectileKind::PIERCE, 100.0f, 260.0f, 0.0f,   maxPierce },
+};
+
+constexpr EnemyArchetype enemyArchetypes[] = {
+    // name      texture               speed  health  range  damage  shot speed
+    { "Goblin", "Assets/Enemy2.png",  2.0f,  50.0f,  5.0f,  50.0f,  200.0f },  // Goblins are faster
+    { "Orc",    "Assets/Enemy.png",   1.0f,  150.0f, 5.0f,  50.0f,  200.0f },  // Orcs have higher health
+};
+
+constexpr int defenderTypeCount = sizeof(defenderArchetypes) / sizeof(defenderArchetypes[0]);
+constexpr int enemyTypeCount = sizeof(enemyArchetypes) / sizeof(enemyArchetypes[0]);
+
+// ------------------------------------------------------------------------
+// Per-type buckets and compile-time iteration over archetype rows
+// ------------------------------------------------------------------------
+template <typename T, size_t N>
+using Buckets = array<vector<T>, N>;
+
+template <typename F, int... I>
+inline void ForEachIndex(F &&f, integer_sequence<int, I...>) {
+    int expand[] = { 0, (f(integral_constant<int, I>()), 0)... };
+    (void)expand;
+}
+
+// Calls f(integral_constant<int, T>) for every row T in [0, N)
+template <int N, typename F>
+inline void ForEachArchetype(F &&f) {
+    ForEachIndex(f, make_integer_sequence<int, N>());
+}
+
+template <typename T, size_t N>
+inline size_t BucketsSize(const Buckets<T, N> &buckets) {
+    size_t total = 0;
+    for (size_t t = 0; t < N; t++) total += buckets[t].size();
+    return total;
+}
+
+// ------------------------------------------------------------------------
+// Factories (placement and spawning are cold paths, so they index by value)
+// ------------------------------------------------------------------------
+inline Defender MakeDefender(int type, int row, int col) {
+    Defender d;
+    d.row = Scalar(row);
+    d.col = Scalar(col);
+    d.attackTimer = Scalar(defenderArchetypes[type].attackCooldown); // so it fires immediately
+    d.currentHealth = Scalar(defenderArchetypes[type].maxHealth);
+    return d;
+}
+
+inline Enemy MakeEnemy(int type, uint32_t id) {
+    Enemy e;
+    e.id = id;
+    e.row = 0;
+    e.col = 0;
+    e.targetCell = -1;
+    e.health = Scalar(enemyArchetypes[type].health);
+    e.isAlive = true;
+    e.hasActiveBullet = false;
+    return e;
+}
+
+// Grid ids for enemies pack the bucket in the top byte and the index below it
+const uint32_t enemyIndexBits = 24;
+const uint32_t enemyIndexMask = (1u << enemyIndexBits) - 1;
+
+inline uint32_t EnemyHandle(int type, size_t index) {
+    return ((uint32_t)type << enemyIndexBits) | (uint32_t)index;
+}
+
+inline Enemy &EnemyAt(Buckets<Enemy, enemyTypeCount> &enemies, uint32_t handle) {
+    return enemies[handle >> enemyIndexBits][handle & enemyIndexMask];
+}
+
+// Defender grid ids use the same packing. Both kinds of handle order like
+// a walk over the buckets (type, then index), which queries use to break
+// distance ties the way the old full scans did.
+inline uint32_t DefenderHandle(int type, size_t index) {
+    return ((uint32_t)type << enemyIndexBits) | (uint32_t)index;
+}
+
+inline Defender &DefenderAt(Buckets<Defender, defenderTypeCount> &defenders, uint32_t handle) {
+    return defenders[handle >> enemyIndexBits][handle & enemyIndexMask];
+}
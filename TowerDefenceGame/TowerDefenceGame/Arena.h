@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// ------------------------------------------------------------------------
+// TickArena: bump allocator for scratch data that dies with the tick
+//
+// Allocation is a pointer bump into one block and freeing is a no-op; the
+// whole arena is released at once by Reset(). When a tick needs more than
+// the block holds, the excess comes from the heap for that tick only and
+// Reset() regrows the block to fit, so like the reused vectors elsewhere
+// it stops touching the heap once it has seen the busiest tick. Owned by
+// one thread; the stats can be read from any.
+// ------------------------------------------------------------------------
+class TickArena {
+public:
+    explicit TickArena(size_t initialBytes)
+        : block(initialBytes), used(0), overflowBytes(0), capacity(initialBytes), peak(0), regrows(0)
+    {}
+
+    ~TickArena() { ReleaseOverflow(); }
+
+    void* Allocate(size_t bytes, size_t align) {
+        size_t start = (used + align - 1) & ~(align - 1);
+        if (start + bytes <= block.size()) {
+            used = start + bytes;
+            return &block[start];
+        }
+        // Out of room: borrow from the heap until the next Reset(), with
+        // slack to round the start up to 'align' as above
+        overflowBytes += bytes + align;
+        unsigned char* extra = new unsigned char[bytes + align - 1];
+        overflow.push_back(extra);
+        uintptr_t aligned = ((uintptr_t)extra + align - 1) & ~(uintptr_t)(align - 1);
+        return (void*)aligned;
+    }
+
+    // Frees everything allocated since the last Reset()
+    void Reset() {
+        size_t demand = used + overflowBytes;
+        if (demand > peak.load(memory_order_relaxed)) peak.store(demand, memory_order_relaxed);
+        if (overflowBytes > 0) {
+            ReleaseOverflow();
+            // Room for this tick's demand plus headroom
+            block.assign(demand + demand / 2, 0);
+            capacity.store(block.size(), memory_order_relaxed);
+            regrows.fetch_add(1, memory_order_relaxed);
+        }
+        used = 0;
+        overflowBytes = 0;
+    }
+
+    // Stats, readable from any thread
+    size_t Capacity() const { return capacity.load(memory_order_relaxed); }
+    size_t Peak() const { return peak.load(memory_order_relaxed); }           // most bytes one tick used
+    int Regrows() const { return regrows.load(memory_order_relaxed); }
+
+private:
+    TickArena(const TickArena &) = delete;
+    TickArena &operator=(const TickArena &) = delete;
+
+    void ReleaseOverflow() {
+        for (size_t i = 0; i < overflow.size(); i++) delete[] overflow[i];
+        overflow.clear();
+    }
+
+    vector<unsigned char> block;
+    vector<unsigned char*> overflow;
+    size_t used;
+    size_t overflowBytes;
+    atomic<size_t> capacity;
+    atomic<size_t> peak;
+    atomic<int> regrows;
+};
+
+// ------------------------------------------------------------------------
+// ArenaAllocator: lets standard containers draw from a TickArena. A
+// ScratchVector must not outlive the arena's next Reset().
+// ------------------------------------------------------------------------
+template <typename T>
+struct ArenaAllocator {
+    typedef T value_type;
+
+    ArenaAllocator(TickArena &a) : arena(&a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return (T*)arena->Allocate(n * sizeof(T), alignof(T)); }
+    void deallocate(T*, size_t) {}
+
+    TickArena* arena;
+};
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) { return a.arena == b.arena; }
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) { return a.arena != b.arena; }
+
+template <typename T>
+using ScratchVector = vector<T, ArenaAllocator<T>>;
+
+// Resets the arena when the enclosing block ends; declare it before the
+// scratch it releases
+class ArenaScope {
+public:
+    explicit ArenaScope(TickArena &a) : arena(a) {}
+    ~ArenaScope() { arena.Reset(); }
+
+private:
+    TickArena &arena;
+};
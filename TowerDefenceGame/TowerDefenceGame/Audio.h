@@ -0,0 +1,150 @@
+#pragma once
+
+#include "raylib.h"
+#include "SpscQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// ------------------------------------------------------------------------
+// Sound effects: one row per effect, decoded once at startup
+// ------------------------------------------------------------------------
+enum SoundEffect {
+    SFX_BULLET,
+    soundEffectCount
+};
+
+const char* const soundEffectPaths[soundEffectCount] = {
+    "Assets/BulletSoundEffect.mp3"
+};
+
+// Most copies of one effect that can sound at once
+const int voicesPerEffect = 8;
+
+struct AudioEvent {
+    uint8_t effect;
+    uint16_t count;     // triggers this event stands for
+};
+
+// ------------------------------------------------------------------------
+// AudioService: music streaming and sound effects on their own thread
+//
+// The audio thread owns the audio device: it streams the music, so a stall
+// on the main thread can no longer starve it, and it plays effects from a
+// fixed pool of voices per effect (each effect's wave is decoded once and
+// shared by its voices). Triggers come in through a lock-free queue from
+// one producer thread. Every audio frame, all triggers of one effect are
+// coalesced into a single play that gets louder with the count, and when
+// the pool is busy the oldest voice is stolen, so the cost stays bounded
+// however many bullets fire.
+// ------------------------------------------------------------------------
+class AudioService {
+public:
+    explicit AudioService(const char* musicFile)
+        : musicPath(musicFile), running(false),
+          played(0), coalesced(0), stolen(0), dropped(0)
+    {}
+
+    ~AudioService() { Stop(); }
+
+    void Start() {
+        if (running.exchange(true)) return;
+        worker = thread([this]() { Loop(); });
+    }
+
+    void Stop() {
+        running.store(false);
+        if (worker.joinable()) worker.join();
+    }
+
+    // Producer thread only. Never blocks; a full queue drops the event.
+    bool Post(SoundEffect effect, int count = 1) {
+        AudioEvent e = { (uint8_t)effect, (uint16_t)min(count, 0xFFFF) };
+        if (events.Push(e)) return true;
+        dropped.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+
+    // Stats, readable from any thread
+    int Played() const { return played.load(memory_order_relaxed); }
+    int Coalesced() const { return coalesced.load(memory_order_relaxed); }
+    int Stolen() const { return stolen.load(memory_order_relaxed); }
+    int Dropped() const { return dropped.load(memory_order_relaxed); }
+
+private:
+    struct Voice {
+        Sound sound;
+        uint64_t startedAt;     // play serial, for stealing the oldest
+    };
+
+    void Loop() {
+        InitAudioDevice();
+        Music music = LoadMusicStream(musicPath.c_str());
+        PlayMusicStream(music);
+        for (int e = 0; e < soundEffectCount; e++) {
+            Wave wave = LoadWave(soundEffectPaths[e]);
+            for (int v = 0; v < voicesPerEffect; v++) {
+                voices[e][v].sound = LoadSoundFromWave(wave);
+                voices[e][v].startedAt = 0;
+            }
+            UnloadWave(wave);
+        }
+
+        // Short frames keep the stream buffers topped up and triggers prompt
+        const chrono::milliseconds frameLength(5);
+        while (running.load(memory_order_acquire)) {
+            UpdateMusicStream(music);
+
+            int triggers[soundEffectCount] = { 0 };
+            AudioEvent e;
+            while (events.Pop(e)) {
+                if (e.effect < soundEffectCount) triggers[e.effect] += e.count;
+            }
+            for (int fx = 0; fx < soundEffectCount; fx++) {
+                if (triggers[fx] > 0) PlayEffect(fx, triggers[fx]);
+            }
+            this_thread::sleep_for(frameLength);
+        }
+
+        for (int fx = 0; fx < soundEffectCount; fx++) {
+            for (int v = 0; v < voicesPerEffect; v++) UnloadSound(voices[fx][v].sound);
+        }
+        UnloadMusicStream(music);
+        CloseAudioDevice();
+    }
+
+    void PlayEffect(int effect, int triggers) {
+        Voice* pool = voices[effect];
+        Voice* voice = nullptr;
+        for (int v = 0; v < voicesPerEffect && !voice; v++) {
+            if (!IsSoundPlaying(pool[v].sound)) voice = &pool[v];
+        }
+        if (!voice) {
+            voice = &pool[0];
+            for (int v = 1; v < voicesPerEffect; v++) {
+                if (pool[v].startedAt < voice->startedAt) voice = &pool[v];
+            }
+            StopSound(voice->sound);
+            stolen.fetch_add(1, memory_order_relaxed);
+        }
+        // A volley sounds louder, never longer
+        SetSoundVolume(voice->sound, min(1.0f, 0.5f + 0.1f * (triggers - 1)));
+        PlaySound(voice->sound);
+        voice->startedAt = ++playSerial;
+        played.fetch_add(1, memory_order_relaxed);
+        coalesced.fetch_add(triggers - 1, memory_order_relaxed);
+    }
+
+    string musicPath;
+    SpscQueue<AudioEvent, 256> events;
+    Voice voices[soundEffectCount][voicesPerEffect];
+    uint64_t playSerial = 0;
+    atomic<bool> running;
+    atomic<int> played, coalesced, stolen, dropped;
+    thread worker;
+};
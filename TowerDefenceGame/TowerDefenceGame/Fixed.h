@@ -0,0 +1,151 @@
+#pragma once
+
+#include "raylib.h"
+#include <cstdint>
+#include <cmath>
+
+using namespace std;
+
+// ------------------------------------------------------------------------
+// Fixed: Q16.16 fixed-point number
+//
+// Every operation is plain integer arithmetic, so results are bit-identical
+// on any compiler, optimisation level or floating-point mode. Products and
+// quotients go through 64 bits and round towards negative infinity. The
+// range is about +-32767, so positions in pixels cap the map at 1023
+// tiles of 32 px a side (see maxWorldPixels); squared distances do not
+// fit either, so lengths go through ScalarLength() instead of dx * dx + dy * dy.
+// ------------------------------------------------------------------------
+struct Fixed {
+    int32_t raw;
+
+    Fixed() = default;
+    constexpr Fixed(int v) : raw(v * 65536) {}
+    // Conversions from floating point are for constants and setup only
+    constexpr Fixed(float v) : raw((int32_t)(v * 65536.0f + (v < 0.0f ? -0.5f : 0.5f))) {}
+    constexpr Fixed(double v) : raw((int32_t)(v * 65536.0 + (v < 0.0 ? -0.5 : 0.5))) {}
+
+    static constexpr Fixed FromRaw(int32_t r) { Fixed f(0); f.raw = r; return f; }
+
+    float ToFloat() const { return raw * (1.0f / 65536.0f); }
+
+    Fixed &operator+=(Fixed b) { raw += b.raw; return *this; }
+    Fixed &operator-=(Fixed b) { raw -= b.raw; return *this; }
+    Fixed &operator*=(Fixed b);
+    Fixed &operator/=(Fixed b);
+};
+
+// Free functions rather than members, so the narrow storage types below
+// (which convert to Fixed) and float literals both work on either side
+inline Fixed operator+(Fixed a, Fixed b) { return Fixed::FromRaw(a.raw + b.raw); }
+inline Fixed operator-(Fixed a, Fixed b) { return Fixed::FromRaw(a.raw - b.raw); }
+inline Fixed operator-(Fixed a) { return Fixed::FromRaw(-a.raw); }
+inline Fixed operator*(Fixed a, Fixed b) { return Fixed::FromRaw((int32_t)(((int64_t)a.raw * b.raw) >> 16)); }
+inline Fixed operator/(Fixed a, Fixed b) { return Fixed::FromRaw((int32_t)(((int64_t)a.raw * 65536) / b.raw)); }
+inline bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+inline bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+inline bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+inline bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+inline bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+inline bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+
+inline Fixed &Fixed::operator*=(Fixed b) { return *this = *this * b; }
+inline Fixed &Fixed::operator/=(Fixed b) { return *this = *this / b; }
+
+// Integer square root: largest r with r * r <= v (bit by bit, no floats)
+inline uint64_t ISqrt(uint64_t v) {
+    uint64_t result = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= result + bit) {
+            v -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+inline Fixed FixedSqrt(Fixed v) {
+    return v.raw <= 0 ? Fixed(0) : Fixed::FromRaw((int32_t)ISqrt((uint64_t)v.raw << 16));
+}
+
+// ------------------------------------------------------------------------
+// Packed16: 16-bit fixed-point storage with F fraction bits
+//
+// For entity fields whose range is known, so the fixed-point build stores
+// them in half the space. Arithmetic widens to Fixed; storing truncates.
+// ------------------------------------------------------------------------
+template <int F>
+struct Packed16 {
+    int16_t raw;
+
+    Packed16() = default;
+    Packed16(Fixed v) : raw((int16_t)(v.raw >> (16 - F))) {}
+    operator Fixed() const { return Fixed::FromRaw((int32_t)raw * (1 << (16 - F))); }
+
+    Packed16 &operator+=(Fixed b) { return *this = Fixed(*this) + b; }
+    Packed16 &operator-=(Fixed b) { return *this = Fixed(*this) - b; }
+};
+
+// ------------------------------------------------------------------------
+// Simulation number types
+//
+// The simulation core is written against these, so one switch picks its
+// arithmetic: float by default, or Q16.16 with SIM_FIXED_POINT defined
+// (make FIXED_POINT=TRUE), which makes replays and lockstep independent of
+// the compiler and build flags. Rendering always works in float and
+// converts with ToFloat().
+// ------------------------------------------------------------------------
+#ifdef SIM_FIXED_POINT
+typedef Fixed Scalar;           // arithmetic and positions
+typedef Packed16<0> TileCoord;  // whole tiles (defender placement)
+typedef Packed16<4> HitPoints;  // Q12.4, up to 2047
+typedef Packed16<12> Seconds;   // Q4.12, timers up to 8 s
+typedef Packed16<6> Speed;      // Q10.6, velocities up to 511 px/s
+typedef int8_t SmallCount;
+typedef uint16_t EnemyTag;      // low bits of an enemy id
+typedef int32_t Gold;
+const int maxWorldPixels = 32767;       // largest position a Fixed holds
+#else
+typedef float Scalar;
+typedef float TileCoord;
+typedef float HitPoints;
+typedef float Seconds;
+typedef float Speed;
+typedef int SmallCount;
+typedef uint32_t EnemyTag;
+typedef float Gold;
+const int maxWorldPixels = 1 << 24;     // beyond this a float drops whole pixels
+#endif
+
+inline float ToFloat(float v) { return v; }
+inline float ToFloat(Fixed v) { return v.ToFloat(); }
+
+// Floor for Fixed, truncation for float: the same for the non-negative
+// values the simulation converts (arithmetic shift on every target compiler)
+inline int FloorToInt(float v) { return (int)v; }
+inline int FloorToInt(Fixed v) { return v.raw >> 16; }
+
+inline float ScalarAbs(float v) { return fabsf(v); }
+inline Fixed ScalarAbs(Fixed v) { return v.raw < 0 ? -v : v; }
+
+// Length of (dx, dy), exact to the last bit in fixed point (the squares
+// are summed in 64 bits, so map-sized distances do not overflow)
+inline float ScalarLength(float dx, float dy) { return sqrtf(dx * dx + dy * dy); }
+inline Fixed ScalarLength(Fixed dx, Fixed dy) {
+    uint64_t sum = (uint64_t)((int64_t)dx.raw * dx.raw) + (uint64_t)((int64_t)dy.raw * dy.raw);
+    return Fixed::FromRaw((int32_t)ISqrt(sum));
+}
+
+// Two-component vector of simulation numbers (raylib's Vector2 in float mode)
+#ifdef SIM_FIXED_POINT
+struct SimVec2 { Scalar x, y; };
+struct SimVelocity { Speed x, y; };
+#else
+typedef Vector2 SimVec2;
+typedef Vector2 SimVelocity;
+#endif
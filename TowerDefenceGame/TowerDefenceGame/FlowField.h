@@ -0,0 +1,220 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <climits>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+using namespace std;
+
+// ------------------------------------------------------------------------
+// FlowField: distance-to-exit field over the walkable cells of the map
+//
+// Every walkable cell stores its step distance to the nearest exit and the
+// neighbouring cell to move to next, so enemies find their way with one
+// lookup no matter how many of them there are. Any number of spawns and
+// exits (and so lanes) is supported.
+//
+// Blocking or unblocking a cell repairs only the affected region: a block
+// invalidates the cells whose route ran through it and re-seeds them from
+// the intact border, an unblock relaxes outwards from the reopened cell.
+// ------------------------------------------------------------------------
+const int flowUnreachable = INT_MAX;
+
+class FlowField {
+public:
+    FlowField(int fieldRows, int fieldCols)
+    {
+        Resize(fieldRows, fieldCols);
+    }
+
+    void Resize(int fieldRows, int fieldCols) {
+        numRows = fieldRows;
+        numCols = fieldCols;
+        int count = numRows * numCols;
+        walkable.assign(count, 0);
+        blockers.assign(count, 0);
+        exitCell.assign(count, 0);
+        dist.assign(count, flowUnreachable);
+        next.assign(count, -1);
+        inRegion.assign(count, 0);
+        spawns.clear();
+        exits.clear();
+    }
+
+    // ---- Layout (call Rebuild() once the layout is complete) ----
+    void SetWalkable(int r, int c, bool w) { walkable[Index(r, c)] = w ? 1 : 0; }
+    void AddSpawn(int r, int c) { SetWalkable(r, c, true); spawns.push_back(Index(r, c)); }
+    void AddExit(int r, int c) {
+        SetWalkable(r, c, true);
+        exitCell[Index(r, c)] = 1;
+        exits.push_back(Index(r, c));
+    }
+
+    // Full recompute from every exit
+    void Rebuild() {
+        fill(dist.begin(), dist.end(), flowUnreachable);
+        fill(next.begin(), next.end(), -1);
+        heap.clear();
+        for (size_t i = 0; i < exits.size(); i++) {
+            if (!Passable(exits[i])) continue;
+            dist[exits[i]] = 0;
+            PushHeap(0, exits[i]);
+        }
+        Propagate();
+    }
+
+    // ---- Incremental updates (e.g. a defender placed on a lane) ----
+
+    // Adds a blocker to a cell. Refuses (returns false, field unchanged) if
+    // that would cut any spawn off from every exit.
+    bool TryBlock(int r, int c) {
+        int cell = Index(r, c);
+        bool wasPassable = Passable(cell);
+        blockers[cell]++;
+        if (!wasPassable) return true;
+        RepairBlocked(cell);
+        if (!AllSpawnsReachable()) {
+            blockers[cell]--;
+            RepairUnblocked(cell);
+            return false;
+        }
+        return true;
+    }
+
+    // Removes a blocker added by TryBlock()
+    void Unblock(int r, int c) {
+        int cell = Index(r, c);
+        if (blockers[cell] == 0) return;
+        blockers[cell]--;
+        if (Passable(cell)) RepairUnblocked(cell);
+    }
+
+    // ---- Sampling ----
+    int Index(int r, int c) const { return r * numCols + c; }
+    int RowOf(int cell) const { return cell / numCols; }
+    int ColOf(int cell) const { return cell % numCols; }
+    bool InBounds(int r, int c) const { return r >= 0 && r < numRows && c >= 0 && c < numCols; }
+    bool IsExit(int cell) const { return exitCell[cell] != 0; }
+    bool Reachable(int cell) const { return dist[cell] != flowUnreachable; }
+    int Distance(int cell) const { return dist[cell]; }
+    int Next(int cell) const { return next[cell]; }   // -1 at exits and unreachable cells
+    const vector<int> &Spawns() const { return spawns; }
+
+    bool AllSpawnsReachable() const {
+        for (size_t i = 0; i < spawns.size(); i++) {
+            if (!Reachable(spawns[i])) return false;
+        }
+        return true;
+    }
+
+private:
+    bool Passable(int cell) const { return walkable[cell] && blockers[cell] == 0; }
+
+    template <typename F>
+    void ForEachNeighbour(int cell, F f) const {
+        int r = RowOf(cell), c = ColOf(cell);
+        if (r > 0)           f(cell - numCols);
+        if (r < numRows - 1) f(cell + numCols);
+        if (c > 0)           f(cell - 1);
+        if (c < numCols - 1) f(cell + 1);
+    }
+
+    void PushHeap(int d, int cell) {
+        heap.push_back(make_pair(d, cell));
+        push_heap(heap.begin(), heap.end(), greater<pair<int, int>>());
+    }
+
+    // Dijkstra from whatever is on the heap; only improves distances
+    void Propagate() {
+        while (!heap.empty()) {
+            pop_heap(heap.begin(), heap.end(), greater<pair<int, int>>());
+            pair<int, int> top = heap.back();
+            heap.pop_back();
+            int d = top.first, cell = top.second;
+            if (d != dist[cell]) continue;  // stale entry
+            ForEachNeighbour(cell, [&](int n) {
+                if (!Passable(n) || dist[n] <= d + 1) return;
+                dist[n] = d + 1;
+                next[n] = cell;
+                PushHeap(d + 1, n);
+            });
+        }
+    }
+
+    // Invalidate every cell whose route ran through 'cell', then refill
+    // them from their still-valid neighbours
+    void RepairBlocked(int cell) {
+        region.clear();
+        region.push_back(cell);
+        inRegion[cell] = 1;
+        for (size_t i = 0; i < region.size(); i++) {
+            int parent = region[i];
+            ForEachNeighbour(parent, [&](int n) {
+                if (!inRegion[n] && next[n] == parent) {
+                    inRegion[n] = 1;
+                    region.push_back(n);
+                }
+            });
+        }
+        for (size_t i = 0; i < region.size(); i++) {
+            dist[region[i]] = flowUnreachable;
+            next[region[i]] = -1;
+        }
+        heap.clear();
+        for (size_t i = 0; i < region.size(); i++) {
+            int r = region[i];
+            if (!Passable(r)) continue;
+            if (IsExit(r)) {
+                dist[r] = 0;
+                PushHeap(0, r);
+                continue;
+            }
+            ForEachNeighbour(r, [&](int n) {
+                if (inRegion[n] || !Passable(n) || !Reachable(n)) return;
+                if (dist[n] + 1 < dist[r]) {
+                    dist[r] = dist[n] + 1;
+                    next[r] = n;
+                }
+            });
+            if (Reachable(r)) PushHeap(dist[r], r);
+        }
+        for (size_t i = 0; i < region.size(); i++) inRegion[region[i]] = 0;
+        Propagate();
+    }
+
+    // Reopened cell: take the best neighbour and relax outwards
+    void RepairUnblocked(int cell) {
+        heap.clear();
+        if (IsExit(cell)) {
+            dist[cell] = 0;
+            next[cell] = -1;
+        } else {
+            ForEachNeighbour(cell, [&](int n) {
+                if (!Passable(n) || !Reachable(n)) return;
+                if (dist[n] + 1 < dist[cell]) {
+                    dist[cell] = dist[n] + 1;
+                    next[cell] = n;
+                }
+            });
+        }
+        if (Reachable(cell)) PushHeap(dist[cell], cell);
+        Propagate();
+    }
+
+    int numRows = 0, numCols = 0;
+    vector<uint8_t> walkable;
+    vector<uint8_t> blockers;
+    vector<uint8_t> exitCell;
+    vector<int> dist;
+    vector<int> next;
+    vector<int> spawns;
+    vector<int> exits;
+
+    // Scratch reused across updates
+    vector<pair<int, int>> heap;
+    vector<int> region;
+    vector<uint8_t> inRegion;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "raylib.h"
+#include "Fixed.h"
+#include <cstdint>
+
+// ------------------------------------------------------------------------
+// Global Constants (the playable map itself is sized at runtime from
+// copies of the authored room)
+// ------------------------------------------------------------------------
+const int roomRows = 16;
+const int roomCols = 22;
+const int tileSize = 32;
+
+// ------------------------------------------------------------------------
+// Defender Types (names for rows of defenderArchetypes)
+// ------------------------------------------------------------------------
+enum class DefenderType {
+    KNIGHT,
+    WIZARD,
+    ARCHER
+};
+
+// ------------------------------------------------------------------------
+// Enemy Types (names for rows of enemyArchetypes)
+// ------------------------------------------------------------------------
+enum class EnemyType {
+    GOBLIN,
+    ORC
+};
+
+// ------------------------------------------------------------------------
+// Projectile behaviours (which defender fired decides how a bullet hits)
+// ------------------------------------------------------------------------
+enum class ProjectileKind {
+    SINGLE,   // damages the first enemy it touches
+    SPLASH,   // damages every enemy within splashRadius of the impact
+    PIERCE    // passes through up to maxPierce enemies along its path
+};
+
+const int maxPierce = 4;
+
+// ------------------------------------------------------------------------
+// Player
+// ------------------------------------------------------------------------
+struct Player {
+    Gold gold;
+
+    Player(Gold g) : gold(g) {}
+};
+
+// ------------------------------------------------------------------------
+// Game Objects (per-unit state only; type stats live in Archetypes.h and
+// the type itself is implied by the bucket an object is stored in).
+// Field types come from Fixed.h; the fixed-point build packs them into
+// 8 / 20 / 24 / 16 bytes against 16 / 24 / 44 / 24 for float.
+// ------------------------------------------------------------------------
+struct Defender {
+    TileCoord row, col;
+    Seconds attackTimer;
+    HitPoints currentHealth;
+};
+
+struct Enemy {
+    uint32_t id;       // stable id, ascending within a bucket
+    Scalar row, col;
+    int targetCell;    // flow-field cell it is walking towards
+    HitPoints health;
+    bool isAlive;
+    bool hasActiveBullet;
+};
+
+struct Bullet {
+    SimVec2 position;             // pixels
+    SimVelocity velocity;         // pixels per second
+    bool active;
+    SmallCount pierceLeft;        // enemies it may still pass through, PIERCE only
+    SmallCount hitCount;
+    EnemyTag hitIds[maxPierce];   // enemies already pierced
+};
+
+// Damage comes from the owner's archetype. Neither this nor Enemy can
+// halve in fixed point: the Q16.16 position alone needs 8 bytes.
+struct EnemyBullet {
+    SimVec2 position;
+    SimVelocity velocity;
+    // the enemy that fired it (bucket + id tag, so it survives compaction)
+    EnemyTag ownerTag;
+    uint8_t ownerType;
+    bool active;
+};
+
+#ifdef SIM_FIXED_POINT
+static_assert(sizeof(Defender) == 8 && sizeof(Enemy) == 20 && sizeof(Bullet) == 24 &&
+              sizeof(EnemyBullet) == 16, "fixed-point entities grew");
+#endif
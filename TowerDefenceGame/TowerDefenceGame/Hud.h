@@ -0,0 +1,248 @@
+#pragma once
+
+#include "raylib.h"
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <climits>
+
+using namespace std;
+
+// What clicking a widget (or the map) asks the game to do
+enum class InputAction : uint8_t {
+    NONE,
+    SELECT_DEFENDER,    // arg: defender archetype row
+    EXIT,
+    REFUND,
+    PLACE               // map clicks only
+};
+
+// Game values a widget can show; the HUD redraws only when one changes
+enum class HudBinding : uint8_t {
+    NONE,
+    GOLD,           // text: format gets the value
+    ENEMIES_LEFT,   // text: format gets the value
+    GAME_OVER,      // shown only while non-zero
+    hudBindingCount
+};
+
+struct HudValues {
+    int gold;
+    int enemiesLeft;
+    bool gameOver;
+};
+
+enum class TextAlign : uint8_t { LEFT, CENTER, RIGHT };
+
+// ------------------------------------------------------------------------
+// HudLayer: retained-mode screen UI
+//
+// Widgets are laid out once at startup and drawn into a cached render
+// texture; each frame costs one textured quad. Sync() compares the bound
+// values with the last ones drawn and re-renders only when one changed,
+// so text is formatted and measured once per change instead of per frame.
+// Clicks are hit-tested against the same widgets, so what is drawn and
+// what is clickable cannot drift apart.
+// ------------------------------------------------------------------------
+class HudLayer {
+public:
+    HudLayer(int width, int height)
+        : target(LoadRenderTexture(width, height)), dirty(true), renders(0)
+    {
+        for (int b = 0; b < (int)HudBinding::hudBindingCount; b++) lastValue[b] = INT_MIN;
+    }
+
+    ~HudLayer() { UnloadRenderTexture(target); }
+
+    // ---- Layout (startup only); each returns the widget id ----
+
+    int AddBox(Rectangle bounds, Color fill, Color outline, float outlineWidth) {
+        Widget w = NewWidget(Widget::BOX, bounds);
+        w.color = fill;
+        w.outline = outline;
+        w.outlineWidth = outlineWidth;
+        return Push(w);
+    }
+
+    // Text placed inside 'bounds' by 'align' (CENTER centres on both axes,
+    // LEFT/RIGHT hang from the top edge). A bound text uses 'text' as its
+    // printf format, so it must then outlive the widget (a literal).
+    int AddText(Rectangle bounds, TextAlign align, const char* text, int fontSize, Color color,
+                float rotation = 0.0f)
+    {
+        Widget w = NewWidget(Widget::TEXT, bounds);
+        w.format = text;
+        w.align = align;
+        w.fontSize = fontSize;
+        w.color = color;
+        w.rotation = rotation;
+        snprintf(w.text, sizeof(w.text), "%s", text);
+        int id = Push(w);
+        Measure(widgets[id]);
+        return id;
+    }
+
+    int AddImage(Texture2D texture, Vector2 position, float scale) {
+        Widget w = NewWidget(Widget::IMAGE, { position.x, position.y,
+                                              texture.width * scale, texture.height * scale });
+        w.texture = texture;
+        w.scale = scale;
+        w.color = WHITE;
+        return Push(w);
+    }
+
+    // Makes a widget clickable
+    void SetAction(int id, InputAction action, int arg = 0) {
+        widgets[id].action = action;
+        widgets[id].arg = arg;
+    }
+
+    void Bind(int id, HudBinding binding) {
+        widgets[id].binding = binding;
+        dirty = true;
+    }
+
+    // ---- Per frame ----
+
+    // Push the current game values; re-renders the cache if any changed.
+    // Call outside BeginMode2D (rendering switches targets).
+    void Sync(const HudValues &values) {
+        int current[(int)HudBinding::hudBindingCount] = { 0, values.gold, values.enemiesLeft, values.gameOver ? 1 : 0 };
+        for (int b = 1; b < (int)HudBinding::hudBindingCount; b++) {
+            if (current[b] == lastValue[b]) continue;
+            lastValue[b] = current[b];
+            for (size_t i = 0; i < widgets.size(); i++) {
+                if ((int)widgets[i].binding == b) Refresh(widgets[i], current[b]);
+            }
+            dirty = true;
+        }
+        if (dirty) Render();
+    }
+
+    void Draw() const {
+        Rectangle flipped = { 0.0f, 0.0f, (float)target.texture.width, -(float)target.texture.height };
+        DrawTextureRec(target.texture, flipped, { 0.0f, 0.0f }, WHITE);
+    }
+
+    // Topmost visible clickable widget under 'point', or NONE
+    InputAction HitTest(Vector2 point, int &arg) const {
+        for (size_t i = widgets.size(); i-- > 0;) {
+            const Widget &w = widgets[i];
+            if (w.action == InputAction::NONE || !w.visible) continue;
+            const Rectangle &rc = w.bounds;
+            if (point.x > rc.x && point.x < rc.x + rc.width &&
+                point.y > rc.y && point.y < rc.y + rc.height) {
+                arg = w.arg;
+                return w.action;
+            }
+        }
+        return InputAction::NONE;
+    }
+
+    // Times the cache has been re-rendered
+    int Renders() const { return renders; }
+
+private:
+    struct Widget {
+        enum Kind { BOX, TEXT, IMAGE } kind;
+        Rectangle bounds;
+        Color color;
+        bool visible;
+        HudBinding binding;
+        InputAction action;
+        int arg;
+        // BOX
+        Color outline;
+        float outlineWidth;
+        // TEXT
+        const char* format;
+        char text[32];
+        TextAlign align;
+        int fontSize;
+        float rotation;
+        Vector2 textPos;
+        int textWidth;
+        // IMAGE
+        Texture2D texture;
+        float scale;
+    };
+
+    Widget NewWidget(Widget::Kind kind, Rectangle bounds) {
+        Widget w = {};
+        w.kind = kind;
+        w.bounds = bounds;
+        w.visible = true;
+        w.binding = HudBinding::NONE;
+        w.action = InputAction::NONE;
+        return w;
+    }
+
+    int Push(const Widget &w) {
+        widgets.push_back(w);
+        dirty = true;
+        return (int)widgets.size() - 1;
+    }
+
+    void Refresh(Widget &w, int value) {
+        if (w.binding == HudBinding::GAME_OVER) {
+            w.visible = value != 0;
+            return;
+        }
+        snprintf(w.text, sizeof(w.text), w.format, value);
+        Measure(w);
+    }
+
+    void Measure(Widget &w) {
+        w.textWidth = MeasureText(w.text, w.fontSize);
+        const Rectangle &b = w.bounds;
+        switch (w.align) {
+            case TextAlign::LEFT:
+                w.textPos = { b.x, b.y };
+                break;
+            case TextAlign::CENTER:
+                w.textPos = { b.x + (b.width - w.textWidth) / 2.0f, b.y + (b.height - w.fontSize) / 2.0f };
+                break;
+            case TextAlign::RIGHT:
+                w.textPos = { b.x + b.width - w.textWidth, b.y };
+                break;
+        }
+    }
+
+    void Render() {
+        BeginTextureMode(target);
+        ClearBackground(BLANK);
+        for (size_t i = 0; i < widgets.size(); i++) {
+            const Widget &w = widgets[i];
+            if (!w.visible) continue;
+            switch (w.kind) {
+                case Widget::BOX:
+                    DrawRectangleRec(w.bounds, w.color);
+                    if (w.outlineWidth > 0.0f) DrawRectangleLinesEx(w.bounds, w.outlineWidth, w.outline);
+                    break;
+                case Widget::TEXT:
+                    if (w.rotation == 0.0f) {
+                        DrawText(w.text, (int)w.textPos.x, (int)w.textPos.y, w.fontSize, w.color);
+                    } else {
+                        // Rotated about the text's own centre
+                        Vector2 origin = { w.textWidth / 2.0f, w.fontSize / 2.0f };
+                        Vector2 pos = { w.textPos.x + origin.x, w.textPos.y + origin.y };
+                        DrawTextPro(GetFontDefault(), w.text, pos, origin, w.rotation,
+                                    (float)w.fontSize, 1.0f, w.color);
+                    }
+                    break;
+                case Widget::IMAGE:
+                    DrawTextureEx(w.texture, { w.bounds.x, w.bounds.y }, 0.0f, w.scale, w.color);
+                    break;
+            }
+        }
+        EndTextureMode();
+        dirty = false;
+        renders++;
+    }
+
+    RenderTexture2D target;
+    vector<Widget> widgets;
+    int lastValue[(int)HudBinding::hudBindingCount];
+    bool dirty;
+    int renders;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "raylib.h"
+#include "GameObjects.h"
+#include "TileMap.h"
+#include "Hud.h"
+#include "Profiler.h"
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+using namespace std;
+
+// ------------------------------------------------------------------------
+// Input layer: captures clicks once per frame with a timestamp and
+// resolves each one against a lookup built at startup
+//
+// The HUD's widgets are tested first; a click on the map resolves through
+// a precomputed placeable-tile mask, so clicks on walls never reach the
+// simulation. The timestamp travels with the resulting command, so latency
+// can be measured end to end.
+// ------------------------------------------------------------------------
+struct InputHit {
+    InputAction action;
+    int arg;            // SELECT_DEFENDER: defender archetype row
+    int row, col;       // PLACE: the tile clicked
+    int64_t timeNs;     // ProfileNow() when the click was captured
+};
+
+class InputLayer {
+public:
+    explicit InputLayer(const TileMap &tileMap)
+        : numRows(tileMap.Rows()), numCols(tileMap.Cols()),
+          placeable((size_t)tileMap.Rows() * tileMap.Cols(), 0)
+    {
+        // The map never changes at runtime, so this is built once
+        for (int r = 0; r < numRows; r++) {
+            for (int c = 0; c < numCols; c++) {
+                if (tileMap.Get(r, c) == 22) placeable[(size_t)r * numCols + c] = 1; // Defender Path
+            }
+        }
+    }
+
+    // Poll once per frame; returns the resolved clicks in arrival order.
+    // Clicks on nothing are dropped here.
+    const vector<InputHit> &Capture(const Camera2D &camera, const HudLayer &hud) {
+        hits.clear();
+        if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+            InputHit hit = Resolve(GetMousePosition(), camera, hud);
+            hit.timeNs = ProfileNow();
+            if (hit.action != InputAction::NONE) hits.push_back(hit);
+        }
+        return hits;
+    }
+
+private:
+    InputHit Resolve(Vector2 mouse, const Camera2D &camera, const HudLayer &hud) const {
+        InputHit hit = { InputAction::NONE, 0, 0, 0, 0 };
+        hit.action = hud.HitTest(mouse, hit.arg);
+        if (hit.action != InputAction::NONE) return hit;
+        Vector2 world = GetScreenToWorld2D(mouse, camera);
+        int c = (int)floorf(world.x / tileSize);
+        int r = (int)floorf(world.y / tileSize);
+        if (r >= 0 && r < numRows && c >= 0 && c < numCols && placeable[(size_t)r * numCols + c]) {
+            hit.action = InputAction::PLACE;
+            hit.row = r;
+            hit.col = c;
+        }
+        return hit;
+    }
+
+    int numRows, numCols;
+    vector<uint8_t> placeable;
+    vector<InputHit> hits;
+};
@@ -0,0 +1,354 @@
+#pragma once
+
+#include "raylib.h"
+#include "Simulation.h"
+#include "Profiler.h"
+#include "Net.h"
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+// ------------------------------------------------------------------------
+// Lockstep: two-player deterministic lockstep over UDP
+//
+// Each peer runs the whole simulation; only commands travel. A command
+// captured while tick N is next is scheduled for tick N + inputDelay, and
+// tick N only runs once both players' commands for it are known. Every
+// packet carries all of the sender's ticks the peer has not acknowledged
+// yet, so a lost packet is covered by the next one without resends or
+// timers. Idle ticks cost nothing on the wire: a packet is a small header
+// plus 6 bytes per command. Each packet also carries the sender's latest
+// state checksum, which the receiver compares with its own for that tick.
+//
+// Packet (little endian):
+//   u8 magic, u8 flags, u16 ack, u16 firstTick, u8 tickCount, u8 commandCount,
+//   [flags & 1: u16 checksumTick, u32 checksum],
+//   commandCount x { u8 tickOffset, u8 type << 4 | defenderType, u16 row, u16 col }
+// Tick numbers travel as their low 16 bits and are unwrapped against the
+// receiver's own position, which is always within a few ticks.
+// ------------------------------------------------------------------------
+struct LockstepConfig {
+    uint16_t localPort = 7777;
+    string remoteHost = "127.0.0.1";
+    uint16_t remotePort = 7778;
+    int player = 0;             // 0 or 1; player 0's commands apply first within a tick
+    int inputDelay = 8;         // ticks from capture to execution
+    int sendInterval = 3;       // ticks between packets
+    float lossRate = 0.0f;      // simulated outgoing packet loss, 0..1
+    int latencyMs = 0;          // simulated one-way delay
+    int jitterMs = 0;           // extra random delay, 0..jitterMs
+};
+
+const int lockstepWindow = 256;         // ticks of history kept; power of two
+const int maxCommandsPerTick = 4;       // per player; extras are dropped
+const int maxPacketBytes = 512;
+const uint8_t lockstepMagic = 0xD7;
+
+class Lockstep {
+public:
+    explicit Lockstep(const LockstepConfig &cfg)
+        : config(cfg), delay(max(1, cfg.inputDelay)),
+          localFinal(0), remoteKnown(0), peerAck(0), lastSumTick(0),
+          pollsSinceSend(0), lossRandom(0xC0FFEEu + cfg.player),
+          rateWindowStart(0), rateWindowBytes(0),
+          bytesSent(0), bytesPerSecond(0), packetsSent(0), packetsDropped(0),
+          commandsDropped(0), stalls(0), confirmedTick(0), desyncTick(-1), peerHeard(false)
+    {
+        // Ticks up to the input delay can have no commands from anyone
+        localFinal = remoteKnown = peerAck = (uint64_t)delay;
+        for (int i = 0; i < lockstepWindow; i++) {
+            local[i].tick = remote[i].tick = (uint64_t)i;
+            local[i].count = remote[i].count = 0;
+            localSums[i].tick = remoteSums[i].tick = 0;
+        }
+        for (int i = 0; i < maxDelayed; i++) delayed[i].used = false;
+        connected = socket.Open(cfg.localPort) && socket.Connect(cfg.remoteHost.c_str(), cfg.remotePort);
+        if (!connected) {
+            TraceLog(LOG_WARNING, "LOCKSTEP: could not open port %i or reach %s:%i",
+                     cfg.localPort, cfg.remoteHost.c_str(), cfg.remotePort);
+        }
+    }
+
+    bool Connected() const { return connected; }
+    int Player() const { return config.player; }
+    int InputDelay() const { return delay; }
+
+    // ---- Simulation thread ----
+
+    // Schedules a local command for the first tick that is still open
+    void Submit(const Command &cmd) {
+        TickInputs &slot = local[(localFinal + 1) & windowMask];
+        if (slot.count >= maxCommandsPerTick) {
+            commandsDropped.fetch_add(1, memory_order_relaxed);
+            return;
+        }
+        slot.cmds[slot.count++] = cmd;
+    }
+
+    // Receive, release delayed packets and send when due. Once per loop.
+    void Poll() {
+        uint8_t buffer[maxPacketBytes];
+        int got;
+        while ((got = socket.Receive(buffer, sizeof(buffer))) > 0) {
+            Parse(buffer, got);
+        }
+        int64_t now = ProfileNow();
+        FlushDelayed(now);
+        if (++pollsSinceSend >= config.sendInterval) {
+            pollsSinceSend = 0;
+            SendInputs();
+        }
+        if (now - rateWindowStart >= 1000000000LL) {
+            bytesPerSecond.store(rateWindowBytes, memory_order_relaxed);
+            rateWindowBytes = 0;
+            rateWindowStart = now;
+        }
+    }
+
+    // Both players' commands for 'tick' are known (and the history window
+    // has room to open the next input tick)
+    bool Ready(uint64_t tick) const {
+        return tick <= remoteKnown && tick <= localFinal &&
+               localFinal + 1 - peerAck < (uint64_t)lockstepWindow;
+    }
+
+    // Commands for 'tick' in execution order (player 0 first)
+    template <typename F>
+    void ForEachCommand(uint64_t tick, F f) const {
+        const TickInputs &mine = local[tick & windowMask];
+        const TickInputs &theirs = remote[tick & windowMask];
+        const TickInputs &first = config.player == 0 ? mine : theirs;
+        const TickInputs &second = config.player == 0 ? theirs : mine;
+        for (int i = 0; i < first.count; i++) f(first.cmds[i]);
+        for (int i = 0; i < second.count; i++) f(second.cmds[i]);
+    }
+
+    // 'tick' has been stepped; closes the next input tick
+    void Advance(uint64_t tick, uint32_t checksum) {
+        localFinal = tick + delay;
+        TickInputs &open = local[(localFinal + 1) & windowMask];
+        open.tick = localFinal + 1;
+        open.count = 0;
+
+        ChecksumSlot &sum = localSums[tick & windowMask];
+        sum.tick = tick;
+        sum.value = checksum;
+        lastSumTick = tick;
+        CompareChecksums(tick);
+        confirmedTick.store((int64_t)tick, memory_order_relaxed);
+    }
+
+    void NoteStall() { stalls.fetch_add(1, memory_order_relaxed); }
+
+    // ---- Stats, readable from any thread ----
+    int BytesPerSecond() const { return bytesPerSecond.load(memory_order_relaxed); }
+    int64_t BytesSent() const { return bytesSent.load(memory_order_relaxed); }
+    int PacketsSent() const { return packetsSent.load(memory_order_relaxed); }
+    int PacketsDropped() const { return packetsDropped.load(memory_order_relaxed); }
+    int CommandsDropped() const { return commandsDropped.load(memory_order_relaxed); }
+    int Stalls() const { return stalls.load(memory_order_relaxed); }
+    int64_t ConfirmedTick() const { return confirmedTick.load(memory_order_relaxed); }
+    int64_t DesyncTick() const { return desyncTick.load(memory_order_relaxed); }   // -1 while in sync
+    bool PeerHeard() const { return peerHeard.load(memory_order_relaxed); }        // any valid packet yet
+
+private:
+    static const uint64_t windowMask = lockstepWindow - 1;
+    static const int maxDelayed = 64;
+    static const int headerBytes = 8;
+    static const int checksumBytes = 6;
+    static const int commandBytes = 6;
+
+    struct TickInputs {
+        uint64_t tick;
+        int count;
+        Command cmds[maxCommandsPerTick];
+    };
+
+    struct ChecksumSlot {
+        uint64_t tick;      // 0: empty
+        uint32_t value;
+    };
+
+    struct DelayedPacket {
+        bool used;
+        int64_t releaseAt;
+        int length;
+        uint8_t data[maxPacketBytes];
+    };
+
+    // ---- Encoding ----
+    static void Put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+    static void Put32(uint8_t* p, uint32_t v) { Put16(p, (uint16_t)v); Put16(p + 2, (uint16_t)(v >> 16)); }
+    static uint16_t Get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+    static uint32_t Get32(const uint8_t* p) { return Get16(p) | ((uint32_t)Get16(p + 2) << 16); }
+
+    // Full tick number nearest to 'reference' with these low 16 bits
+    static uint64_t Unwrap(uint16_t low, uint64_t reference) {
+        int64_t t = (int64_t)reference + (int16_t)(uint16_t)(low - (uint16_t)reference);
+        return t < 0 ? 0 : (uint64_t)t;
+    }
+
+    void SendInputs() {
+        uint8_t packet[maxPacketBytes];
+        uint64_t first = peerAck + 1;
+        uint64_t last = min(localFinal, first + 254);
+        bool withSum = lastSumTick > 0;
+        int size = headerBytes + (withSum ? checksumBytes : 0);
+        int commands = 0;
+
+        // Stop at a tick boundary if the commands would not fit
+        for (uint64_t t = first; t <= last; t++) {
+            const TickInputs &slot = local[t & windowMask];
+            if (size + slot.count * commandBytes > maxPacketBytes) {
+                last = t - 1;
+                break;
+            }
+            for (int i = 0; i < slot.count; i++) {
+                const Command &c = slot.cmds[i];
+                uint8_t* p = packet + size;
+                p[0] = (uint8_t)(t - first);
+                p[1] = (uint8_t)(((int)c.type << 4) | (c.defenderType & 0x0F));
+                Put16(p + 2, (uint16_t)c.row);
+                Put16(p + 4, (uint16_t)c.col);
+                size += commandBytes;
+                commands++;
+            }
+        }
+
+        packet[0] = lockstepMagic;
+        packet[1] = withSum ? 1 : 0;
+        Put16(packet + 2, (uint16_t)remoteKnown);
+        Put16(packet + 4, (uint16_t)first);
+        packet[6] = (uint8_t)(last + 1 - first);
+        packet[7] = (uint8_t)commands;
+        if (withSum) {
+            Put16(packet + headerBytes, (uint16_t)lastSumTick);
+            Put32(packet + headerBytes + 2, localSums[lastSumTick & windowMask].value);
+        }
+        Transmit(packet, size);
+    }
+
+    void Parse(const uint8_t* packet, int length) {
+        if (length < headerBytes || packet[0] != lockstepMagic) return;
+        bool withSum = (packet[1] & 1) != 0;
+        int count = packet[6];
+        int commands = packet[7];
+        int offset = headerBytes + (withSum ? checksumBytes : 0);
+        if (length < offset + commands * commandBytes) return;
+        peerHeard.store(true, memory_order_relaxed);
+
+        uint64_t ack = Unwrap(Get16(packet + 2), peerAck);
+        if (ack > peerAck && ack <= localFinal) peerAck = ack;
+
+        uint64_t first = Unwrap(Get16(packet + 4), remoteKnown + 1);
+        uint64_t last = first + count - 1;
+        if (count > 0 && first <= remoteKnown + 1 && last > remoteKnown) {
+            uint64_t known = remoteKnown;
+            for (uint64_t t = known + 1; t <= last; t++) {
+                TickInputs &slot = remote[t & windowMask];
+                slot.tick = t;
+                slot.count = 0;
+            }
+            for (int i = 0; i < commands; i++) {
+                const uint8_t* p = packet + offset + i * commandBytes;
+                uint64_t t = first + p[0];
+                if (t <= known || t > last) continue;
+                TickInputs &slot = remote[t & windowMask];
+                if (slot.count >= maxCommandsPerTick) continue;
+                Command c;
+                c.type = (CommandType)(p[1] >> 4);
+                c.defenderType = p[1] & 0x0F;
+                c.row = Get16(p + 2);
+                c.col = Get16(p + 4);
+                c.issuedAt = 0;
+                slot.cmds[slot.count++] = c;
+            }
+            remoteKnown = last;
+        }
+
+        if (withSum) {
+            uint64_t sumTick = Unwrap(Get16(packet + headerBytes), lastSumTick);
+            ChecksumSlot &sum = remoteSums[sumTick & windowMask];
+            sum.tick = sumTick;
+            sum.value = Get32(packet + headerBytes + 2);
+            CompareChecksums(sumTick);
+        }
+    }
+
+    void CompareChecksums(uint64_t tick) {
+        const ChecksumSlot &mine = localSums[tick & windowMask];
+        const ChecksumSlot &theirs = remoteSums[tick & windowMask];
+        if (tick == 0 || mine.tick != tick || theirs.tick != tick) return;
+        if (mine.value != theirs.value && desyncTick.load(memory_order_relaxed) < 0) {
+            desyncTick.store((int64_t)tick, memory_order_relaxed);
+            TraceLog(LOG_WARNING, "LOCKSTEP: desync at tick %i (local %08x, remote %08x)",
+                     (int)tick, mine.value, theirs.value);
+        }
+    }
+
+    // Sends now, or later through the simulated lossy link
+    void Transmit(const uint8_t* data, int length) {
+        packetsSent.fetch_add(1, memory_order_relaxed);
+        bytesSent.fetch_add(length, memory_order_relaxed);
+        rateWindowBytes += length;
+        if (config.lossRate > 0.0f && (lossRandom.Next() & 0xFFFF) < config.lossRate * 65536.0f) {
+            packetsDropped.fetch_add(1, memory_order_relaxed);
+            return;
+        }
+        if (config.latencyMs <= 0 && config.jitterMs <= 0) {
+            socket.Send(data, length);
+            return;
+        }
+        for (int i = 0; i < maxDelayed; i++) {
+            DelayedPacket &d = delayed[i];
+            if (d.used) continue;
+            int jitter = config.jitterMs > 0 ? lossRandom.Range(0, config.jitterMs) : 0;
+            d.used = true;
+            d.releaseAt = ProfileNow() + (int64_t)(config.latencyMs + jitter) * 1000000;
+            d.length = length;
+            copy(data, data + length, d.data);
+            return;
+        }
+        packetsDropped.fetch_add(1, memory_order_relaxed);   // link saturated
+    }
+
+    void FlushDelayed(int64_t now) {
+        for (int i = 0; i < maxDelayed; i++) {
+            DelayedPacket &d = delayed[i];
+            if (!d.used || d.releaseAt > now) continue;
+            socket.Send(d.data, d.length);
+            d.used = false;
+        }
+    }
+
+    LockstepConfig config;
+    int delay;
+    UdpSocket socket;
+    bool connected;
+
+    TickInputs local[lockstepWindow];
+    TickInputs remote[lockstepWindow];
+    ChecksumSlot localSums[lockstepWindow];
+    ChecksumSlot remoteSums[lockstepWindow];
+    uint64_t localFinal;    // last local tick whose commands are closed
+    uint64_t remoteKnown;   // last tick with the peer's commands all received
+    uint64_t peerAck;       // last of our ticks the peer has confirmed
+    uint64_t lastSumTick;   // newest tick with a local checksum
+    int pollsSinceSend;
+
+    // Simulated link
+    SimRandom lossRandom;
+    DelayedPacket delayed[maxDelayed];
+
+    int64_t rateWindowStart;
+    int rateWindowBytes;
+    atomic<int64_t> bytesSent;
+    atomic<int> bytesPerSecond;
+    atomic<int> packetsSent, packetsDropped, commandsDropped, stalls;
+    atomic<int64_t> confirmedTick;
+    atomic<int64_t> desyncTick;
+    atomic<bool> peerHeard;
+};
@@ -0,0 +1,108 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+// ------------------------------------------------------------------------
+// MappedFile
+// ------------------------------------------------------------------------
+MappedFile::MappedFile()
+    : data(nullptr), size(0), fileHandle(nullptr), mappingHandle(nullptr), fd(-1)
+{}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Create(const char* path, size_t bytes) {
+    return Map(true, path, bytes);
+}
+
+bool MappedFile::OpenExisting(const char* path) {
+    return Map(false, path, 0);
+}
+
+#ifdef _WIN32
+bool MappedFile::Map(bool create, const char* path, size_t bytes) {
+    Close();
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    if (!create) {
+        LARGE_INTEGER length;
+        if (!GetFileSizeEx(file, &length) || length.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        bytes = (size_t)length.QuadPart;
+    }
+    // Creating the mapping at this size also extends a new file to it
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                        (DWORD)((unsigned long long)bytes >> 32), (DWORD)bytes, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = view;
+    size = bytes;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle((HANDLE)mappingHandle);
+    if (fileHandle) CloseHandle((HANDLE)fileHandle);
+    data = nullptr;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+    size = 0;
+}
+#else
+bool MappedFile::Map(bool create, const char* path, size_t bytes) {
+    Close();
+    int file = open(path, create ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR, 0644);
+    if (file < 0) return false;
+    if (create) {
+        // Truncated to zero above, so this zero fills
+        if (ftruncate(file, (off_t)bytes) != 0) {
+            close(file);
+            return false;
+        }
+    } else {
+        struct stat info;
+        if (fstat(file, &info) != 0 || info.st_size == 0) {
+            close(file);
+            return false;
+        }
+        bytes = (size_t)info.st_size;
+    }
+    void* view = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (view == MAP_FAILED) {
+        close(file);
+        return false;
+    }
+    fd = file;
+    data = view;
+    size = bytes;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) munmap(data, size);
+    if (fd >= 0) close(fd);
+    data = nullptr;
+    fd = -1;
+    size = 0;
+}
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+// ------------------------------------------------------------------------
+// MappedFile: a file mapped read/write into memory and shared with any
+// other process that maps it
+//
+// Like Net.h, the platform headers (windows.h on Windows) clash with
+// raylib's names, so they stay inside MappedFile.cpp.
+// ------------------------------------------------------------------------
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // Creates 'path' (replacing any old file) at 'size' bytes, zero filled
+    bool Create(const char* path, size_t size);
+    // Maps an existing file at its current size
+    bool OpenExisting(const char* path);
+    void Close();
+
+    void* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool Map(bool create, const char* path, size_t bytes);
+
+    void* data;
+    size_t size;
+    void* fileHandle;       // HANDLE on Windows, unused elsewhere
+    void* mappingHandle;    // HANDLE on Windows, unused elsewhere
+    int fd;                 // POSIX descriptor, -1 when closed
+};
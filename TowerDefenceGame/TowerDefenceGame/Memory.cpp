@@ -0,0 +1,33 @@
+#include "Memory.h"
+
+#include <cstdlib>
+#include <new>
+
+AllocCounter allocCounters[profilePhaseCount + 1];
+
+// ------------------------------------------------------------------------
+// Counting global operator new, and the matching deletes (the array and
+// nothrow forms of the standard library forward to these)
+// ------------------------------------------------------------------------
+static void* CountedAlloc(size_t size) {
+    int phase = CurrentProfilePhase();
+    allocCounters[phase].count.fetch_add(1, memory_order_relaxed);
+    allocCounters[phase].bytes.fetch_add((int64_t)size, memory_order_relaxed);
+    ThreadAllocCount()++;
+    return malloc(size ? size : 1);
+}
+
+void* operator new(size_t size) {
+    void* p = CountedAlloc(size);
+    if (!p) throw bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Profiler.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// ------------------------------------------------------------------------
+// Heap allocation counters
+//
+// Memory.cpp replaces the global operator new/delete, so every C++ heap
+// allocation in the program (vector growth, strings, new) is counted and
+// charged to the profile phase its thread is in, or to "other" outside
+// any phase. Raylib's own C allocations are not seen. Link Memory.cpp
+// into any program that reads these.
+// ------------------------------------------------------------------------
+const int allocOther = profilePhaseCount;
+
+struct AllocCounter {
+    atomic<int64_t> count;
+    atomic<int64_t> bytes;
+};
+
+// One per phase plus allocOther; defined in Memory.cpp
+extern AllocCounter allocCounters[profilePhaseCount + 1];
+
+// Allocations made by the calling thread so far
+inline int64_t &ThreadAllocCount() {
+    static thread_local int64_t count = 0;
+    return count;
+}
+
+inline int64_t AllocCount(int phase) { return allocCounters[phase].count.load(memory_order_relaxed); }
+inline int64_t AllocBytes(int phase) { return allocCounters[phase].bytes.load(memory_order_relaxed); }
+
+inline int64_t AllocCountTotal() {
+    int64_t total = 0;
+    for (int p = 0; p <= profilePhaseCount; p++) total += AllocCount(p);
+    return total;
+}
+
+inline int64_t AllocBytesTotal() {
+    int64_t total = 0;
+    for (int p = 0; p <= profilePhaseCount; p++) total += AllocBytes(p);
+    return total;
+}
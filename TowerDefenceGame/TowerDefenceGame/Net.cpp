@@ -0,0 +1,138 @@
+#include "Net.h"
+
+#include <cstring>
+#include <cerrno>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    typedef int socklen_t;
+    static const intptr_t invalidSocket = (intptr_t)INVALID_SOCKET;
+#else
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <netdb.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    static const intptr_t invalidSocket = -1;
+#endif
+
+static_assert(sizeof(sockaddr_in) <= 16, "peer storage too small for sockaddr_in");
+
+// ------------------------------------------------------------------------
+// Platform helpers
+// ------------------------------------------------------------------------
+#ifdef _WIN32
+static int socketUsers = 0;
+
+static bool StartSockets() {
+    if (socketUsers++ > 0) return true;
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+}
+
+static void StopSockets() {
+    if (--socketUsers == 0) WSACleanup();
+}
+
+static void CloseSocketHandle(intptr_t h) { closesocket((SOCKET)h); }
+
+static bool SetNonBlocking(intptr_t h) {
+    u_long on = 1;
+    return ioctlsocket((SOCKET)h, FIONBIO, &on) == 0;
+}
+#else
+static bool StartSockets() { return true; }
+static void StopSockets() {}
+static void CloseSocketHandle(intptr_t h) { close((int)h); }
+
+static bool SetNonBlocking(intptr_t h) {
+    int flags = fcntl((int)h, F_GETFL, 0);
+    return flags >= 0 && fcntl((int)h, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+#endif
+
+// ------------------------------------------------------------------------
+// UdpSocket
+// ------------------------------------------------------------------------
+UdpSocket::UdpSocket() : handle(invalidSocket), hasPeer(false) {
+    memset(peer, 0, sizeof(peer));
+}
+
+UdpSocket::~UdpSocket() {
+    Close();
+}
+
+bool UdpSocket::Open(uint16_t localPort) {
+    Close();
+    if (!StartSockets()) return false;
+    handle = (intptr_t)socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle == invalidSocket) {
+        StopSockets();
+        return false;
+    }
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(localPort);
+    if (bind(handle, (const sockaddr*)&local, sizeof(local)) != 0 || !SetNonBlocking(handle)) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool UdpSocket::Connect(const char* host, uint16_t port) {
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found = nullptr;
+    if (getaddrinfo(host, nullptr, &hints, &found) != 0 || !found) return false;
+    sockaddr_in addr;
+    memcpy(&addr, found->ai_addr, sizeof(addr));
+    freeaddrinfo(found);
+    addr.sin_port = htons(port);
+    memcpy(peer, &addr, sizeof(addr));
+    hasPeer = true;
+    return true;
+}
+
+void UdpSocket::Close() {
+    if (handle == invalidSocket) return;
+    CloseSocketHandle(handle);
+    handle = invalidSocket;
+    StopSockets();
+}
+
+bool UdpSocket::Send(const uint8_t* data, int length) {
+    if (handle == invalidSocket || !hasPeer) return false;
+    int sent = (int)sendto(handle, (const char*)data, length, 0, (const sockaddr*)peer, sizeof(sockaddr_in));
+    return sent == length;
+}
+
+int UdpSocket::Receive(uint8_t* buffer, int capacity) {
+    if (handle == invalidSocket) return -1;
+    for (;;) {
+        sockaddr_in from;
+        socklen_t fromLen = sizeof(from);
+        int got = (int)recvfrom(handle, (char*)buffer, capacity, 0, (sockaddr*)&from, &fromLen);
+        if (got < 0) {
+#ifdef _WIN32
+            int err = WSAGetLastError();
+            // A send to a closed port shows up as a reset on the next receive
+            if (err == WSAEWOULDBLOCK || err == WSAECONNRESET) return 0;
+#else
+            if (errno == EWOULDBLOCK || errno == EAGAIN || errno == ECONNREFUSED) return 0;
+#endif
+            return -1;
+        }
+        const sockaddr_in &expected = *(const sockaddr_in*)peer;
+        if (hasPeer && (from.sin_addr.s_addr != expected.sin_addr.s_addr || from.sin_port != expected.sin_port)) {
+            continue;   // not our peer
+        }
+        return got;
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+// ------------------------------------------------------------------------
+// UdpSocket: minimal non-blocking UDP endpoint talking to one peer
+//
+// The platform socket headers (winsock2.h on Windows) clash with raylib's
+// names, so they are only included by Net.cpp and nothing here depends on
+// them.
+// ------------------------------------------------------------------------
+class UdpSocket {
+public:
+    UdpSocket();
+    ~UdpSocket();
+
+    // Bind to 'localPort' on all interfaces
+    bool Open(uint16_t localPort);
+    // Resolve the peer; Send() goes there and Receive() ignores anyone else
+    bool Connect(const char* host, uint16_t port);
+    void Close();
+
+    bool Send(const uint8_t* data, int length);
+    // Bytes read into 'buffer', 0 if nothing is waiting, -1 on error
+    int Receive(uint8_t* buffer, int capacity);
+
+private:
+    UdpSocket(const UdpSocket &) = delete;
+    UdpSocket &operator=(const UdpSocket &) = delete;
+
+    intptr_t handle;
+    alignas(8) unsigned char peer[16];   // sockaddr_in
+    bool hasPeer;
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+using namespace std;
+
+// ------------------------------------------------------------------------
+// Profiler: per-phase timers and latency stats, readable from any thread
+//
+// Every stat has a single writer thread (the simulation's phases are
+// written by the simulation thread, input and draw by the main thread),
+// so recording is a handful of relaxed stores and never waits. Readers may
+// see a stat mid-update, which is fine for an on-screen overlay.
+// ------------------------------------------------------------------------
+enum ProfilePhase {
+    PHASE_INPUT,
+    PHASE_COMMANDS,
+    PHASE_SPAWN,
+    PHASE_ENEMIES,
+    PHASE_DEFENDERS,
+    PHASE_ENEMY_SHOTS,
+    PHASE_BULLETS,
+    PHASE_ENEMY_BULLETS,
+    PHASE_SNAPSHOT,
+    PHASE_DRAW,
+    profilePhaseCount
+};
+
+const char* const profilePhaseNames[profilePhaseCount] = {
+    "input", "commands", "spawn", "enemies", "defenders",
+    "enemy shots", "bullets", "enemy bullets", "snapshot", "draw"
+};
+
+// Monotonic clock shared by both threads, in nanoseconds
+inline int64_t ProfileNow() {
+    return chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class ProfileStat {
+public:
+    ProfileStat() : count(0), lastNs(0), smoothedNs(0), maxNs(0) {}
+
+    // Writer thread only
+    void Record(int64_t ns) {
+        int64_t n = count.load(memory_order_relaxed);
+        int64_t smoothed = n == 0 ? ns : smoothedNs.load(memory_order_relaxed);
+        smoothedNs.store(smoothed + (ns - smoothed) / 16, memory_order_relaxed);
+        lastNs.store(ns, memory_order_relaxed);
+        if (ns > maxNs.load(memory_order_relaxed)) maxNs.store(ns, memory_order_relaxed);
+        count.store(n + 1, memory_order_relaxed);
+    }
+
+    int64_t Count() const { return count.load(memory_order_relaxed); }
+    int64_t LastNs() const { return lastNs.load(memory_order_relaxed); }
+    double LastMs() const { return LastNs() * 1e-6; }
+    double AverageMs() const { return smoothedNs.load(memory_order_relaxed) * 1e-6; }  // ~16-sample moving average
+    double MaxMs() const { return maxNs.load(memory_order_relaxed) * 1e-6; }
+
+private:
+    atomic<int64_t> count;
+    atomic<int64_t> lastNs;
+    atomic<int64_t> smoothedNs;
+    atomic<int64_t> maxNs;
+};
+
+class Profiler {
+public:
+    void Record(ProfilePhase phase, int64_t ns) { phases[phase].Record(ns); }
+    const ProfileStat &Phase(ProfilePhase phase) const { return phases[phase]; }
+
+    // Click captured -> placement applied by the simulation
+    ProfileStat clickToApply;
+    // Click captured -> first frame drawn with the placement in it
+    ProfileStat clickToFrame;
+
+private:
+    ProfileStat phases[profilePhaseCount];
+};
+
+// Phase the calling thread is inside (profilePhaseCount outside any), so
+// heap allocations can be charged to it (see Memory.h)
+inline int &CurrentProfilePhase() {
+    static thread_local int phase = profilePhaseCount;
+    return phase;
+}
+
+// Times the enclosing block into one phase
+class ProfileScope {
+public:
+    ProfileScope(Profiler &p, ProfilePhase ph)
+        : profiler(p), phase(ph), outer(CurrentProfilePhase()), start(ProfileNow())
+    {
+        CurrentProfilePhase() = ph;
+    }
+
+    ~ProfileScope() {
+        profiler.Record(phase, ProfileNow() - start);
+        CurrentProfilePhase() = outer;
+    }
+
+private:
+    Profiler &profiler;
+    ProfilePhase phase;
+    int outer;
+    int64_t start;
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "GameObjects.h"
+#include "Archetypes.h"
+#include "SpatialGrid.h"
+#include "Arena.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// Contact distance between a bullet and an enemy centre (16px, in tiles)
+const Scalar projectileHitRadius = 0.5f;
+
+// Grid query results for one tick, drawn from the tick arena
+typedef ScratchVector<uint32_t> HitList;
+
+// ------------------------------------------------------------------------
+// Fire a bullet from defender archetype T heading along 'direction'
+// ------------------------------------------------------------------------
+template <int T>
+inline void FireProjectile(vector<Bullet> &bucket, SimVec2 origin, SimVec2 direction) {
+    constexpr const DefenderArchetype &a = defenderArchetypes[T];
+    constexpr Scalar speed = a.bulletSpeed;
+    Bullet b;
+    b.position = origin;
+    b.velocity = { direction.x * speed, direction.y * speed };
+    b.active = true;
+    b.pierceLeft = a.pierce;
+    b.hitCount = 0;
+    bucket.push_back(b);
+}
+
+// ------------------------------------------------------------------------
+// Projectile update (all hit tests go through the enemy grid, so a splash
+// or pierce never scans the full enemy list)
+// ------------------------------------------------------------------------
+
+// Grid entry ids are EnemyHandles; positions are enemy centres in tiles
+inline void RebuildEnemyGrid(SpatialGrid &grid, const Buckets<Enemy, enemyTypeCount> &enemies) {
+    grid.Clear();
+    for (int t = 0; t < enemyTypeCount; t++) {
+        const vector<Enemy> &bucket = enemies[t];
+        for (size_t i = 0; i < bucket.size(); i++) {
+            if (!bucket[i].isAlive) continue;
+            grid.Insert(EnemyHandle(t, i), bucket[i].col + 0.5f, bucket[i].row + 0.5f);
+        }
+    }
+    grid.Build();
+}
+
+inline void DamageEnemy(Enemy &e, Scalar damage, int &kills) {
+    if (!e.isAlive) return;
+    e.health -= damage;
+    if (e.health <= 0) {
+        e.isAlive = false;
+        kills++;
+    }
+}
+
+// Kernel for the bullets of defender archetype T. 'grid' must have been
+// rebuilt from 'enemies' this tick. Returns the number of kills.
+template <int T>
+inline int UpdateProjectileBucket(vector<Bullet> &bucket, Buckets<Enemy, enemyTypeCount> &enemies,
+                                  const SpatialGrid &grid, Scalar deltaTime, Scalar worldW, Scalar worldH,
+                                  HitList &hits)
+{
+    constexpr ProjectileKind kind = defenderArchetypes[T].projectile;
+    constexpr Scalar damage = defenderArchetypes[T].damage;
+    constexpr Scalar splashRadius = defenderArchetypes[T].splashRadius;
+    const Scalar invTile = 1.0f / tileSize;
+    int kills = 0;
+
+    for (size_t i = 0; i < bucket.size(); i++) {
+        Bullet &b = bucket[i];
+        Scalar x0 = b.position.x * invTile, y0 = b.position.y * invTile;
+        b.position.x += b.velocity.x * deltaTime;
+        b.position.y += b.velocity.y * deltaTime;
+
+        if (b.position.x < 0 || b.position.x > worldW ||
+            b.position.y < 0 || b.position.y > worldH) {
+            b.active = false;
+            continue;
+        }
+
+        // Swept test so fast bullets cannot skip over an enemy
+        Scalar x1 = b.position.x * invTile, y1 = b.position.y * invTile;
+        grid.QuerySegment(x0, y0, x1, y1, projectileHitRadius, hits);
+
+        if (kind == ProjectileKind::PIERCE) {
+            for (size_t h = 0; h < hits.size() && b.pierceLeft > 0; h++) {
+                Enemy &e = EnemyAt(enemies, hits[h]);
+                if (!e.isAlive) continue;
+                EnemyTag tag = (EnemyTag)e.id;
+                if (find(b.hitIds, b.hitIds + b.hitCount, tag) != b.hitIds + b.hitCount) continue;
+                DamageEnemy(e, damage, kills);
+                b.hitIds[b.hitCount++] = tag;
+                b.pierceLeft--;
+            }
+            if (b.pierceLeft <= 0) b.active = false;
+        } else {
+            Enemy* struck = nullptr;
+            for (size_t h = 0; h < hits.size() && !struck; h++) {
+                Enemy &e = EnemyAt(enemies, hits[h]);
+                if (e.isAlive) struck = &e;
+            }
+            if (!struck) continue;
+            b.active = false;
+            if (kind == ProjectileKind::SPLASH) {
+                grid.QueryRadius(struck->col + 0.5f, struck->row + 0.5f, splashRadius, hits);
+                for (size_t h = 0; h < hits.size(); h++) {
+                    DamageEnemy(EnemyAt(enemies, hits[h]), damage, kills);
+                }
+            } else {
+                DamageEnemy(*struck, damage, kills);
+            }
+        }
+    }
+    // Remove inactive bullets
+    bucket.erase(remove_if(bucket.begin(), bucket.end(),
+        [](const Bullet &b) { return !b.active; }), bucket.end());
+    return kills;
+}
+
+inline int UpdateProjectiles(Buckets<Bullet, defenderTypeCount> &bullets, Buckets<Enemy, enemyTypeCount> &enemies,
+                             const SpatialGrid &grid, Scalar deltaTime, Scalar worldW, Scalar worldH,
+                             HitList &hits)
+{
+    int kills = 0;
+    ForEachArchetype<defenderTypeCount>([&](auto t) {
+        kills += UpdateProjectileBucket<decltype(t)::value>(bullets[t], enemies, grid, deltaTime, worldW, worldH, hits);
+    });
+    return kills;
+}
@@ -0,0 +1,797 @@
+#pragma once
+
+#include "raylib.h"
+#include "raymath.h"
+#include "GameObjects.h"
+#include "Archetypes.h"
+#include "SpatialGrid.h"
+#include "Projectiles.h"
+#include "FlowField.h"
+#include "TileMap.h"
+#include "Profiler.h"
+#include "Arena.h"
+#include "Telemetry.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+// Length of one simulation tick; the simulation always advances by this
+const float simTickSeconds = 1.0f / 60.0f;
+
+// ------------------------------------------------------------------------
+// SimRandom: small seeded generator (xorshift32) owned by the simulation,
+// so two runs with the same seed and inputs make the same choices
+// ------------------------------------------------------------------------
+class SimRandom {
+public:
+    explicit SimRandom(uint32_t seed) : state(seed ? seed : 0x9E3779B9u) {}
+
+    uint32_t Next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // Uniform in [lo, hi]
+    int Range(int lo, int hi) { return lo + (int)(Next() % (uint32_t)(hi - lo + 1)); }
+
+    uint32_t State() const { return state; }
+
+private:
+    uint32_t state;
+};
+
+// ------------------------------------------------------------------------
+// Commands: player input, queued by the main thread and applied by the
+// simulation at the start of its next tick
+// ------------------------------------------------------------------------
+enum class CommandType : uint8_t {
+    PLACE_DEFENDER,
+    REFUND_ALL
+};
+
+struct Command {
+    CommandType type;
+    uint8_t defenderType;   // PLACE_DEFENDER only
+    int row, col;           // PLACE_DEFENDER only
+    int64_t issuedAt;       // ProfileNow() when the click was captured, 0 if remote
+};
+
+// ------------------------------------------------------------------------
+// Render snapshot: everything the main thread needs to draw one frame
+//
+// Sprite ids index the renderer's sprite table (one row per defender and
+// enemy archetype, then the bullet and the three heart states). Sprites are
+// grouped by layer and then by map chunk, so the renderer only walks the
+// chunks in view.
+// ------------------------------------------------------------------------
+const int spriteDefender = 0;                                  // + defender archetype row
+const int spriteEnemy = spriteDefender + defenderTypeCount;    // + enemy archetype row
+const int spriteBullet = spriteEnemy + enemyTypeCount;
+const int spriteHeartFull = spriteBullet + 1;
+const int spriteHeartHalf = spriteBullet + 2;
+const int spriteHeartEmpty = spriteBullet + 3;
+const int spriteCount = spriteBullet + 4;
+
+enum RenderLayer {
+    LAYER_ENEMIES,
+    LAYER_DEFENDERS,
+    LAYER_BULLETS,
+    renderLayerCount
+};
+
+struct SpriteInstance {
+    float x, y;         // world pixels (bullets: centre, others: top-left)
+    float rotation;     // degrees
+    uint16_t sprite;
+};
+
+struct RenderSnapshot {
+    uint64_t tick = 0;
+    int gold = 0;
+    int enemiesLeft = 0;
+    bool gameOver = false;
+    int64_t placedAt = 0;   // issue time of the newest placement applied so far
+
+    // A run of sprites sharing a layer and a map chunk
+    struct SpriteBin {
+        int chunkRow, chunkCol;
+        int first, end;     // range in sprites
+    };
+    vector<SpriteInstance> sprites;
+    vector<SpriteBin> bins;     // occupied bins only, by layer then chunk (draw order)
+};
+
+// ------------------------------------------------------------------------
+// Simulation: all game state and the fixed-step update
+//
+// Owned by the simulation thread once running; the main thread only talks
+// to it through commands and snapshots. The tile map is fixed after
+// construction, which is what lets the renderer bake it without a lock.
+// Given the same seed and the same commands on the same ticks, Step() is
+// deterministic, which is what lockstep multiplayer relies on.
+// ------------------------------------------------------------------------
+// Most rooms the map can have on each side while its edges, in pixels,
+// stay inside the range of Scalar: 63 x 46 rooms (1008 x 1012 tiles) in
+// the fixed-point build
+const int maxRoomsDown = maxWorldPixels / (roomRows * tileSize);
+const int maxRoomsAcross = maxWorldPixels / (roomCols * tileSize);
+static_assert(maxRoomsDown >= 1 && maxRoomsAcross >= 1, "one room must fit in the range of Scalar");
+
+class Simulation {
+public:
+    // The map is a roomsDown x roomsAcross grid of copies of the authored
+    // room, each with its own lane; 1 x 1 is the original game. Counts past
+    // maxRoomsDown / maxRoomsAcross are clamped to them.
+    Simulation(int roomsDown = 1, int roomsAcross = 1, uint32_t seed = 1)
+        : player(9999), defenders(), enemies(), bullets(), enemyBullets(),
+          tileMap(RoomsToRows(roomsDown), RoomsToCols(roomsAcross)),
+          mapRows(RoomsToRows(roomsDown)), mapCols(RoomsToCols(roomsAcross)),
+          worldWidth(mapCols * tileSize), worldHeight(mapRows * tileSize),
+          enemyGrid(mapRows, mapCols, 2.0f), defenderGrid(mapRows, mapCols, 2.0f),
+          defenderGridDirty(false), nextEnemyId(1),
+          gameOver(false), enemiesReached(10), totalEnemiesToSpawn(20),
+          spawnedEnemiesCount(0), spawnTimer(0.0f), spawnDelay(2.0f), // spawn delay now 2 sec
+          flowField(mapRows, mapCols), random(seed), tick(0), shotsFired(0), placedAt(0),
+          arena(64 * 1024)
+    {
+        // Copy your original map layout
+        uint8_t roomMap[roomRows][roomCols] = {
+            {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
+            {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
+            {1,1,5,2,7,2,7,2,7,2,7,2,7,7,7,2,7,2,6,1,1,1},
+            {1,1,3,22,22,22,22,22,22,22,22,22,22,22,22,22,22,22,4,1,1,1},
+            {1,1,3,22,22,22,22,22,22,22,22,22,22,22,22,22,22,22,4,1,1,1},
+            {1,1,8,8,8,8,8,8,8,12,15,22,20,8,8,8,15,22,4,1,1,1},
+            {1,1,11,11,11,11,11,11,11,16,3,22,4,17,11,16,3,22,4,1,1,1},
+            {1,1,3,22,22,22,22,22,22,4,3,22,4,3,22,4,3,22,4,1,1,1},
+            {1,1,3,22,22,22,22,22,22,4,3,22,4,3,22,4,3,22,4,1,1,1},
+            {1,1,3,22,22,22,22,22,22,4,9,8,10,3,22,4,3,22,4,1,1,1},
+            {1,1,3,22,22,22,22,22,22,18,11,11,11,19,22,4,3,22,4,1,1,1},
+            {1,1,3,22,22,22,22,22,22,22,22,22,22,22,22,4,3,22,4,1,1,1},
+            {1,1,3,22,22,22,22,22,22,22,22,22,22,22,22,4,3,22,4,1,1,1},
+            {1,1,9,8,8,8,8,8,8,8,8,8,8,8,8,14,13,8,10,1,1,1},
+            {1,1,21,21,21,21,1,1,1,1,1,1,1,1,1,21,21,21,21,1,1,1},
+            {1,1,21,21,21,21,1,1,1,1,1,1,1,1,1,21,21,21,21,1,1,1}
+        };
+
+        // Lane layout: '#' walkable, 'S' spawn, 'E' exit, '.' blocked
+        const char* laneLayout[roomRows] = {
+            "......................",
+            "......................",
+            "......................",
+            "......................",
+            "......................",
+            "......................",
+            ".S#########..###......",
+            "..........#..#.#......",
+            "..........#..#.#......",
+            "..........#..#.#......",
+            "..........####.#......",
+            "...............#......",
+            "...............E......",
+            "......................",
+            "......................",
+            "......................"
+        };
+        for (int r = 0; r < mapRows; r++) {
+            for (int c = 0; c < mapCols; c++) {
+                tileMap.Set(r, c, roomMap[r % roomRows][c % roomCols]);
+                switch (laneLayout[r % roomRows][c % roomCols]) {
+                    case '#': flowField.SetWalkable(r, c, true); break;
+                    case 'S': flowField.AddSpawn(r, c); break;
+                    case 'E': flowField.AddExit(r, c); break;
+                }
+            }
+        }
+        flowField.Rebuild();
+        // The whole wave fits without growing, so spawning never allocates
+        for (int t = 0; t < enemyTypeCount; t++) enemies[t].reserve(totalEnemiesToSpawn);
+        enemyGrid.Reserve(totalEnemiesToSpawn);
+        enemyBullets.reserve(totalEnemiesToSpawn);   // one shot per enemy
+    }
+
+    const TileMap &Map() const { return tileMap; }
+    float WorldWidth() const { return ToFloat(worldWidth); }
+    float WorldHeight() const { return ToFloat(worldHeight); }
+    uint64_t Tick() const { return tick; }
+    int ShotsFired() const { return shotsFired; }   // defender shots in the last tick
+    Profiler &Profile() { return profiler; }
+    const TickArena &Scratch() const { return arena; }
+
+    // --------------------------------------------------------------------
+    // Apply one queued player command
+    // --------------------------------------------------------------------
+    void Apply(const Command &cmd) {
+        switch (cmd.type) {
+            case CommandType::PLACE_DEFENDER: {
+                int r = cmd.row, c = cmd.col;
+                int type = cmd.defenderType;
+                if (type >= defenderTypeCount || !tileMap.InBounds(r, c)) break;
+                if (tileMap.Get(r, c) != 22) break; // Defender Path
+                Gold costNeeded = (Gold)defenderArchetypes[type].cost;
+                // A defender blocks its cell, unless that would seal off a
+                // spawn or leave a live enemy with no way to an exit
+                if (player.gold < costNeeded || !flowField.TryBlock(r, c)) break;
+                if (StrandsAnEnemy()) {
+                    flowField.Unblock(r, c);
+                    break;
+                }
+                player.gold -= costNeeded;
+                defenders[type].push_back(MakeDefender(type, r, c));
+                // Grow the grid and bullet bucket here, so ticks do not allocate
+                defenderGrid.Reserve(BucketsSize(defenders));
+                bullets[type].reserve(defenders[type].size() * BulletsInFlight(type));
+                defenderGridDirty = true;
+                if (cmd.issuedAt != 0) {
+                    profiler.clickToApply.Record(ProfileNow() - cmd.issuedAt);
+                    placedAt = cmd.issuedAt;
+                }
+                break;
+            }
+            case CommandType::REFUND_ALL:
+                player.gold += DeleteAllDefenders();
+                defenderGridDirty = true;
+                break;
+        }
+    }
+
+    // --------------------------------------------------------------------
+    // Advance the game by one tick
+    // --------------------------------------------------------------------
+    void Step(Scalar deltaTime) {
+        // Scratch data lives until the end of the tick
+        ArenaScope scratch(arena);
+        tick++;
+        shotsFired = 0;
+        // ----------------------------------------------------------------
+        // 1) Spawn enemy using a single spawn timer with random enemy type
+        // ----------------------------------------------------------------
+        {
+            ProfileScope scope(profiler, PHASE_SPAWN);
+            spawnTimer += deltaTime;
+            if (spawnedEnemiesCount < totalEnemiesToSpawn && spawnTimer >= spawnDelay) {
+                spawnTimer = 0;
+                // Randomly select an enemy archetype
+                int chosenType = random.Range(0, enemyTypeCount - 1);
+                Enemy newEnemy = MakeEnemy(chosenType, nextEnemyId++);
+                // Spawn points take turns, so every lane gets enemies
+                const vector<int> &spawns = flowField.Spawns();
+                int spawnCell = spawns[spawnedEnemiesCount % spawns.size()];
+                newEnemy.row = flowField.RowOf(spawnCell);
+                newEnemy.col = flowField.ColOf(spawnCell);
+                newEnemy.targetCell = spawnCell;
+                enemies[chosenType].push_back(newEnemy);
+                spawnedEnemiesCount++;
+            }
+        }
+        // 2) Update enemies
+        {
+            ProfileScope scope(profiler, PHASE_ENEMIES);
+            ForEachArchetype<enemyTypeCount>([&](auto t) {
+                UpdateEnemies<decltype(t)::value>(enemies[t], deltaTime, totalEnemiesToSpawn);
+            });
+            for (int t = 0; t < enemyTypeCount; t++) {
+                enemies[t].erase(remove_if(enemies[t].begin(), enemies[t].end(),
+                    [](const Enemy &e) { return !e.isAlive; }), enemies[t].end());
+            }
+            // Enemies hold still for the rest of the tick, so defender
+            // targeting and defender bullets share one grid
+            RebuildEnemyGrid(enemyGrid, enemies);
+        }
+        // 3) Update defenders (each may spawn a bullet)
+        {
+            ProfileScope scope(profiler, PHASE_DEFENDERS);
+            ForEachArchetype<defenderTypeCount>([&](auto t) {
+                UpdateDefenders<decltype(t)::value>(defenders[t], deltaTime);
+            });
+        }
+        // 4) Update enemy shooting (one bullet per enemy)
+        {
+            ProfileScope scope(profiler, PHASE_ENEMY_SHOTS);
+            if (defenderGridDirty) RebuildDefenderGrid();
+            ForEachArchetype<enemyTypeCount>([&](auto t) {
+                UpdateEnemyShooting<decltype(t)::value>(enemies[t]);
+            });
+        }
+        // 5) Update defender bullets
+        {
+            ProfileScope scope(profiler, PHASE_BULLETS);
+            UpdateBullets(deltaTime, worldWidth, worldHeight);
+        }
+        // 6) Update enemy bullets
+        {
+            ProfileScope scope(profiler, PHASE_ENEMY_BULLETS);
+            UpdateEnemyBullets(deltaTime, worldWidth, worldHeight);
+            RemoveDeadDefenders();
+        }
+    }
+
+    // --------------------------------------------------------------------
+    // Checksum of the gameplay state (FNV-1a over the raw bits), compared
+    // between lockstep peers to catch a divergence on the tick it happens
+    // --------------------------------------------------------------------
+    uint32_t Checksum() const {
+        uint32_t h = 2166136261u;
+        Mix(h, tick);
+        Mix(h, random.State());
+        Mix(h, player.gold);
+        Mix(h, enemiesReached);
+        Mix(h, spawnedEnemiesCount);
+        Mix(h, spawnTimer);
+        Mix(h, nextEnemyId);
+        for (int t = 0; t < enemyTypeCount; t++) {
+            for (size_t i = 0; i < enemies[t].size(); i++) {
+                const Enemy &e = enemies[t][i];
+                Mix(h, e.id);
+                Mix(h, e.row);
+                Mix(h, e.col);
+                Mix(h, e.targetCell);
+                Mix(h, e.health);
+                Mix(h, e.hasActiveBullet);
+            }
+        }
+        for (int t = 0; t < defenderTypeCount; t++) {
+            for (size_t i = 0; i < defenders[t].size(); i++) {
+                const Defender &d = defenders[t][i];
+                Mix(h, d.row);
+                Mix(h, d.col);
+                Mix(h, d.attackTimer);
+                Mix(h, d.currentHealth);
+            }
+            for (size_t i = 0; i < bullets[t].size(); i++) {
+                Mix(h, bullets[t][i].position);
+                Mix(h, bullets[t][i].pierceLeft);
+            }
+        }
+        for (size_t i = 0; i < enemyBullets.size(); i++) {
+            Mix(h, enemyBullets[i].position);
+            Mix(h, enemyBullets[i].ownerTag);
+        }
+        return h;
+    }
+
+    // --------------------------------------------------------------------
+    // Write the current state into 'out' (a reused snapshot slot, so its
+    // vectors stop allocating once they have grown to the busiest frame)
+    // --------------------------------------------------------------------
+    void WriteSnapshot(RenderSnapshot &out) {
+        ProfileScope scope(profiler, PHASE_SNAPSHOT);
+        ArenaScope scratch(arena);
+        out.tick = tick;
+        out.gold = (int)player.gold;
+        out.enemiesLeft = (totalEnemiesToSpawn - spawnedEnemiesCount) + (int)BucketsSize(enemies);
+        out.gameOver = gameOver;
+        out.placedAt = placedAt;
+
+        // Render command list, sized up front so it is a single arena block
+        StageList staged(arena);
+        staged.reserve(BucketsSize(enemies) + 2 * BucketsSize(defenders) +
+                       BucketsSize(bullets) + enemyBullets.size());
+        for (int t = 0; t < enemyTypeCount; t++) {
+            for (size_t i = 0; i < enemies[t].size(); i++) {
+                const Enemy &e = enemies[t][i];
+                if (!e.isAlive) continue;
+                Stage(staged, LAYER_ENEMIES, spriteEnemy + t, ToFloat(e.col) * tileSize, ToFloat(e.row) * tileSize, 0.0f);
+            }
+        }
+        for (int t = 0; t < defenderTypeCount; t++) {
+            float maxHealth = defenderArchetypes[t].maxHealth;
+            for (size_t i = 0; i < defenders[t].size(); i++) {
+                const Defender &d = defenders[t][i];
+                float tileX = ToFloat(d.col) * tileSize;
+                float tileY = ToFloat(d.row) * tileSize;
+                float healthRatio = ToFloat(d.currentHealth) / maxHealth;
+                int heart = healthRatio >= 1.0f ? spriteHeartFull
+                          : healthRatio >= 0.5f ? spriteHeartHalf : spriteHeartEmpty;
+                // The heart sits one tile below, binned with its defender
+                Stage(staged, LAYER_DEFENDERS, heart, tileX, tileY + tileSize, 0.0f, tileX, tileY);
+                Stage(staged, LAYER_DEFENDERS, spriteDefender + t, tileX, tileY, 0.0f);
+            }
+        }
+        for (int t = 0; t < defenderTypeCount; t++) {
+            for (size_t i = 0; i < bullets[t].size(); i++) {
+                StageBullet(staged, bullets[t][i].position, bullets[t][i].velocity);
+            }
+        }
+        for (size_t i = 0; i < enemyBullets.size(); i++) {
+            StageBullet(staged, enemyBullets[i].position, enemyBullets[i].velocity);
+        }
+
+        // Sort by (layer, chunk), staging order breaking ties so draw order
+        // within a bin holds. Only occupied bins are written, so the cost
+        // follows the number of sprites, not the size of the map.
+        sort(staged.begin(), staged.end(), [](const StagedSprite &a, const StagedSprite &b) {
+            return a.bin < b.bin || (a.bin == b.bin && a.seq < b.seq);
+        });
+        int chunkCount = tileMap.ChunkRows() * tileMap.ChunkCols();
+        out.sprites.resize(staged.size());
+        out.bins.clear();
+        for (size_t i = 0; i < staged.size(); i++) {
+            out.sprites[i] = staged[i].sprite;
+            if (i == 0 || staged[i].bin != staged[i - 1].bin) {
+                int chunk = staged[i].bin % chunkCount;
+                out.bins.push_back({ chunk / tileMap.ChunkCols(), chunk % tileMap.ChunkCols(), (int)i, (int)i });
+            }
+            out.bins.back().end = (int)i + 1;
+        }
+    }
+
+    // --------------------------------------------------------------------
+    // Fill the gameplay metrics of a telemetry record for the last tick
+    // --------------------------------------------------------------------
+    void WriteTelemetry(TelemetryRecord &out) const {
+        out.tick = tick;
+        out.gold = (int32_t)player.gold;
+        out.enemiesReached = enemiesReached;
+        out.enemiesAlive = (int32_t)BucketsSize(enemies);
+        out.projectilesAlive = (int32_t)(BucketsSize(bullets) + enemyBullets.size());
+        out.defendersAlive = (int32_t)BucketsSize(defenders);
+        out.defenderHealth = 0.0f;
+        for (int t = 0; t < defenderTypeCount; t++) {
+            for (size_t i = 0; i < defenders[t].size(); i++) {
+                out.defenderHealth += ToFloat(defenders[t][i].currentHealth);
+            }
+        }
+        for (int p = 0; p < profilePhaseCount; p++) {
+            out.phaseNs[p] = (uint32_t)profiler.Phase((ProfilePhase)p).LastNs();
+        }
+    }
+
+private:
+    static int RoomsToRows(int roomsDown) { return roomRows * max(1, min(roomsDown, maxRoomsDown)); }
+    static int RoomsToCols(int roomsAcross) { return roomCols * max(1, min(roomsAcross, maxRoomsAcross)); }
+
+    template <typename V>
+    static void Mix(uint32_t &h, const V &value) {
+        unsigned char bytes[sizeof(V)];
+        memcpy(bytes, &value, sizeof(V));
+        for (size_t i = 0; i < sizeof(V); i++) {
+            h = (h ^ bytes[i]) * 16777619u;
+        }
+    }
+
+    struct StagedSprite {
+        SpriteInstance sprite;
+        int bin;        // layer * chunk count + chunk
+        int seq;        // staging order
+    };
+    typedef ScratchVector<StagedSprite> StageList;
+
+    // Bins by the chunk under (binX, binY); defaults to the sprite position
+    void Stage(StageList &staged, int layer, int sprite, float x, float y, float rotation) {
+        Stage(staged, layer, sprite, x, y, rotation, x, y);
+    }
+
+    void Stage(StageList &staged, int layer, int sprite, float x, float y, float rotation, float binX, float binY) {
+        const float chunkPx = (float)(chunkSize * tileSize);
+        int cc = min(tileMap.ChunkCols() - 1, max(0, (int)floorf(binX / chunkPx)));
+        int cr = min(tileMap.ChunkRows() - 1, max(0, (int)floorf(binY / chunkPx)));
+        StagedSprite s;
+        s.sprite = { x, y, rotation, (uint16_t)sprite };
+        s.bin = layer * tileMap.ChunkRows() * tileMap.ChunkCols() + tileMap.ChunkIndex(cr, cc);
+        s.seq = (int)staged.size();
+        staged.push_back(s);
+    }
+
+    void StageBullet(StageList &staged, SimVec2 position, SimVelocity velocity) {
+        float angleDeg = atan2f(ToFloat(velocity.y), ToFloat(velocity.x)) * RAD2DEG;
+        Stage(staged, LAYER_BULLETS, spriteBullet, ToFloat(position.x), ToFloat(position.y), angleDeg);
+    }
+
+    // Unit vector from 'from' (pixels) towards the centre of tile (row, col)
+    static SimVec2 Aim(SimVec2 from, Scalar col, Scalar row) {
+        Scalar dx = (col + 0.5f) * tileSize - from.x;
+        Scalar dy = (row + 0.5f) * tileSize - from.y;
+        Scalar distance = ScalarLength(dx, dy);
+        if (distance > 0) {
+            dx = dx / distance;
+            dy = dy / distance;
+        }
+        return { dx, dy };
+    }
+
+    // Most bullets one defender of archetype 'type' can have in the air: a
+    // shot per cooldown, each lasting at most a map diagonal of flight
+    int BulletsInFlight(int type) const {
+        const DefenderArchetype &a = defenderArchetypes[type];
+        float w = ToFloat(worldWidth), h = ToFloat(worldHeight);
+        return (int)ceilf(sqrtf(w * w + h * h) / a.bulletSpeed / a.attackCooldown) + 1;
+    }
+
+    // Flow-field cell nearest an enemy's position
+    int StandingCell(const Enemy &e) const {
+        return flowField.Index(FloorToInt(e.row + 0.5f), FloorToInt(e.col + 0.5f));
+    }
+
+    // True if some live enemy stands on a cell the flow field cannot route
+    // to an exit (the blocked cell itself or one it cut off)
+    bool StrandsAnEnemy() const {
+        for (int t = 0; t < enemyTypeCount; t++) {
+            for (size_t i = 0; i < enemies[t].size(); i++) {
+                const Enemy &e = enemies[t][i];
+                if (e.isAlive && !flowField.Reachable(StandingCell(e))) return true;
+            }
+        }
+        return false;
+    }
+
+    // --------------------------------------------------------------------
+    // Update Enemies: moves every enemy of archetype T along the flow field
+    // --------------------------------------------------------------------
+    template <int T>
+    void UpdateEnemies(vector<Enemy> &bucket, Scalar deltaTime, int totalEnemies) {
+        constexpr Scalar move = enemyArchetypes[T].speed;
+        for (size_t i = 0; i < bucket.size(); i++) {
+            Enemy &enemy = bucket[i];
+            if (!enemy.isAlive) continue;
+
+            // Target cut off by a map change: re-enter the field where we
+            // stand (placement keeps that cell reachable)
+            if (!flowField.Reachable(enemy.targetCell)) {
+                enemy.targetCell = StandingCell(enemy);
+            }
+
+            Scalar targetRow = flowField.RowOf(enemy.targetCell);
+            Scalar targetCol = flowField.ColOf(enemy.targetCell);
+            Scalar dRow = targetRow - enemy.row;
+            Scalar dCol = targetCol - enemy.col;
+            Scalar distance = ScalarLength(dRow, dCol);
+
+            if (distance < 0.1f) {
+                if (flowField.IsExit(enemy.targetCell)) {
+                    enemy.isAlive = false;
+                    enemiesReached++;
+                    if (enemiesReached >= totalEnemies) {
+                        gameOver = true;
+                    }
+                } else if (flowField.Reachable(enemy.targetCell)) {
+                    enemy.targetCell = flowField.Next(enemy.targetCell);
+                }
+            } else {
+                Scalar step = move * deltaTime / distance;
+                enemy.row += dRow * step;
+                enemy.col += dCol * step;
+            }
+        }
+    }
+
+    // --------------------------------------------------------------------
+    // Update Defenders: each defender of archetype T fires at the closest
+    // enemy within its range
+    // --------------------------------------------------------------------
+    template <int T>
+    void UpdateDefenders(vector<Defender> &bucket, Scalar deltaTime) {
+        constexpr Scalar cooldown = defenderArchetypes[T].attackCooldown;
+        constexpr Scalar range = defenderArchetypes[T].attackRange;
+        HitList inRange(arena);
+        for (size_t d = 0; d < bucket.size(); d++) {
+            Defender &def = bucket[d];
+            def.attackTimer += deltaTime;
+            if (def.attackTimer < cooldown) continue;
+
+            enemyGrid.QueryRadius(def.col + 0.5f, def.row + 0.5f, range, inRange);
+            const Enemy* closestEnemy = nullptr;
+            uint32_t closestHandle = 0;
+            Scalar closestDist = 0;
+            for (size_t h = 0; h < inRange.size(); h++) {
+                const Enemy &e = EnemyAt(enemies, inRange[h]);
+                if (!e.isAlive) continue;
+                Scalar dist = ScalarLength(e.row - def.row, e.col - def.col);
+                // On a tie the lower handle wins, as in bucket order
+                if (!closestEnemy || dist < closestDist || (dist == closestDist && inRange[h] < closestHandle)) {
+                    closestDist = dist;
+                    closestEnemy = &e;
+                    closestHandle = inRange[h];
+                }
+            }
+
+            if (closestEnemy) {
+                SimVec2 defenderCenter = { (def.col + 0.5f) * tileSize, (def.row + 0.5f) * tileSize };
+                SimVec2 direction = Aim(defenderCenter, closestEnemy->col, closestEnemy->row);
+                FireProjectile<T>(bullets[T], defenderCenter, direction);
+                shotsFired++;
+            }
+            def.attackTimer = Scalar(0);
+        }
+    }
+
+    // --------------------------------------------------------------------
+    // Update Bullets (defender bullets); the enemy grid was rebuilt after
+    // the enemies moved
+    // --------------------------------------------------------------------
+    void UpdateBullets(Scalar deltaTime, Scalar worldW, Scalar worldH) {
+        HitList hits(arena);
+        int kills = UpdateProjectiles(bullets, enemies, enemyGrid, deltaTime,
+                                      worldW, worldH, hits);
+        player.gold += 50 * kills;
+    }
+
+    // --------------------------------------------------------------------
+    // Enemy Bullet Functionality
+    // --------------------------------------------------------------------
+
+    // Grid entry ids are DefenderHandles; positions are defender centres in
+    // tiles. Defenders never move, so this only runs after the set changes.
+    void RebuildDefenderGrid() {
+        defenderGrid.Clear();
+        for (int t = 0; t < defenderTypeCount; t++) {
+            for (size_t i = 0; i < defenders[t].size(); i++) {
+                defenderGrid.Insert(DefenderHandle(t, i), defenders[t][i].col + 0.5f, defenders[t][i].row + 0.5f);
+            }
+        }
+        defenderGrid.Build();
+        defenderGridDirty = false;
+    }
+
+    template <int T>
+    void UpdateEnemyShooting(vector<Enemy> &bucket) {
+        constexpr const EnemyArchetype &a = enemyArchetypes[T];
+        constexpr Scalar range = a.attackRange;
+        constexpr Scalar shotSpeed = a.shotSpeed;
+        HitList nearby(arena);
+        for (size_t i = 0; i < bucket.size(); i++) {
+            Enemy &e = bucket[i];
+            if (!e.isAlive) continue;
+            if (e.hasActiveBullet) continue;  // Ensures each enemy only has one bullet at a time
+
+            defenderGrid.QueryRadius(e.col + 0.5f, e.row + 0.5f, range, nearby);
+            const Defender* target = nullptr;
+            uint32_t targetHandle = 0;
+            Scalar closestDist = range;
+            for (size_t h = 0; h < nearby.size(); h++) {
+                const Defender &d = DefenderAt(defenders, nearby[h]);
+                Scalar dist = ScalarLength(d.row - e.row, d.col - e.col);
+                // Check if the defender is within the enemy's attack range
+                // (on a tie the lower handle wins, as in bucket order)
+                if (dist < closestDist || (target && dist == closestDist && nearby[h] < targetHandle)) {
+                    closestDist = dist;
+                    target = &d;
+                    targetHandle = nearby[h];
+                }
+            }
+            if (target) {
+                SimVec2 enemyCenter = { (e.col + 0.5f) * tileSize, (e.row + 0.5f) * tileSize };
+                SimVec2 direction = Aim(enemyCenter, target->col, target->row);
+                EnemyBullet newBullet;
+                newBullet.position = enemyCenter;
+                newBullet.velocity = { direction.x * shotSpeed, direction.y * shotSpeed };
+                newBullet.ownerTag = (EnemyTag)e.id;
+                newBullet.ownerType = T;
+                newBullet.active = true;
+                enemyBullets.push_back(newBullet);
+                e.hasActiveBullet = true;
+            }
+        }
+    }
+
+    // Let the owner fire again. Ids ascend within a bucket and its live
+    // enemies are far fewer than a tag can count, so tags taken relative to
+    // the first id ascend too (across wrap-around) and binary search works.
+    void ReleaseEnemyShot(const EnemyBullet &b) {
+        vector<Enemy> &bucket = enemies[b.ownerType];
+        if (bucket.empty()) return;
+        EnemyTag base = (EnemyTag)bucket.front().id;
+        EnemyTag key = (EnemyTag)(b.ownerTag - base);
+        auto it = lower_bound(bucket.begin(), bucket.end(), key,
+            [base](const Enemy &e, EnemyTag k) { return (EnemyTag)(e.id - base) < k; });
+        if (it != bucket.end() && (EnemyTag)it->id == b.ownerTag) {
+            it->hasActiveBullet = false;
+        }
+    }
+
+    void UpdateEnemyBullets(Scalar deltaTime, Scalar worldW, Scalar worldH) {
+        const Scalar collisionRange = 16;
+        const Scalar invTile = 1.0f / tileSize;
+        HitList nearby(arena);
+        for (size_t i = 0; i < enemyBullets.size(); i++) {
+            EnemyBullet &b = enemyBullets[i];
+            if (!b.active) continue;
+            b.position.x += b.velocity.x * deltaTime;
+            b.position.y += b.velocity.y * deltaTime;
+
+            if (b.position.x < 0 || b.position.x > worldW ||
+                b.position.y < 0 || b.position.y > worldH) {
+                ReleaseEnemyShot(b);
+                b.active = false;
+                continue;
+            }
+            // Candidates within a tile (twice the collision range, so
+            // rounding to tiles cannot drop one); the pixel test decides
+            defenderGrid.QueryRadius(b.position.x * invTile, b.position.y * invTile, Scalar(1), nearby);
+            Defender* struck = nullptr;
+            uint32_t struckHandle = 0;
+            for (size_t h = 0; h < nearby.size(); h++) {
+                Defender &d = DefenderAt(defenders, nearby[h]);
+                Scalar dx = b.position.x - (d.col + 0.5f) * tileSize;
+                Scalar dy = b.position.y - (d.row + 0.5f) * tileSize;
+                // Box test first keeps the squares small enough for fixed point
+                if (ScalarAbs(dx) >= collisionRange || ScalarAbs(dy) >= collisionRange) continue;
+                // The first defender in bucket order is hit
+                if (dx * dx + dy * dy < collisionRange * collisionRange &&
+                    (!struck || nearby[h] < struckHandle)) {
+                    struck = &d;
+                    struckHandle = nearby[h];
+                }
+            }
+            if (struck) {
+                struck->currentHealth -= Scalar(enemyArchetypes[b.ownerType].shotDamage);
+                ReleaseEnemyShot(b);
+                b.active = false;
+            }
+        }
+        enemyBullets.erase(remove_if(enemyBullets.begin(), enemyBullets.end(),
+            [](const EnemyBullet &eb) { return !eb.active; }), enemyBullets.end());
+    }
+
+    void RemoveDeadDefenders() {
+        for (int t = 0; t < defenderTypeCount; t++) {
+            size_t before = defenders[t].size();
+            defenders[t].erase(remove_if(defenders[t].begin(), defenders[t].end(),
+                [this](const Defender &d) {
+                    if (d.currentHealth > 0) return false;
+                    flowField.Unblock(FloorToInt(d.row), FloorToInt(d.col));
+                    return true;
+                }), defenders[t].end());
+            if (defenders[t].size() != before) defenderGridDirty = true;
+        }
+    }
+
+    // --------------------------------------------------------------------
+    // Delete All Defenders: remove all defenders and return total refund
+    // --------------------------------------------------------------------
+    Gold DeleteAllDefenders() {
+        Gold totalRefund = 0;
+        for (int t = 0; t < defenderTypeCount; t++) {
+            totalRefund += (Gold)defenderArchetypes[t].cost * (Gold)defenders[t].size();
+            for (size_t i = 0; i < defenders[t].size(); i++) {
+                flowField.Unblock(FloorToInt(defenders[t][i].row), FloorToInt(defenders[t][i].col));
+            }
+            defenders[t].clear();
+        }
+        return totalRefund;
+    }
+
+    // Game state objects (one bucket per archetype row)
+    Player player;
+    Buckets<Defender, defenderTypeCount> defenders;
+    Buckets<Enemy, enemyTypeCount> enemies;
+    Buckets<Bullet, defenderTypeCount> bullets;
+    vector<EnemyBullet> enemyBullets;
+
+    // Map and game variables
+    TileMap tileMap;
+    int mapRows, mapCols;
+    Scalar worldWidth, worldHeight;
+
+    // Broad phase for defender targeting and projectile hits, rebuilt each tick
+    SpatialGrid enemyGrid;
+    // Broad phase for enemy shots and bullets, rebuilt when defenders change
+    SpatialGrid defenderGrid;
+    bool defenderGridDirty;
+    uint32_t nextEnemyId;
+
+    bool gameOver;
+    int enemiesReached;
+    int totalEnemiesToSpawn;
+    int spawnedEnemiesCount;
+    Scalar spawnTimer;
+    const Scalar spawnDelay;
+
+    // Enemy routing: distance/flow field towards the exits of the lane layout
+    FlowField flowField;
+    SimRandom random;
+    uint64_t tick;
+    int shotsFired;
+
+    Profiler profiler;
+    int64_t placedAt;
+
+    // Per-tick scratch (grid query results, render command lists)
+    TickArena arena;
+};
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "Simulation.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+#include "Audio.h"
+#include "Lockstep.h"
+#include "Memory.h"
+#include "Telemetry.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+
+// ------------------------------------------------------------------------
+// SimulationThread: runs a Simulation at a fixed tick on its own thread
+//
+// Input goes in through a command queue and frames come out through a
+// triple-buffered snapshot, so the main thread and the simulation never
+// wait on each other. A full command queue drops the command (and counts
+// it) rather than stalling the main thread. Sound triggers go straight to
+// the audio service, which makes this thread its only producer.
+//
+// With a Lockstep attached, commands are scheduled through it instead of
+// applied at once, and a tick only runs when both players' input for it
+// has arrived; until then the thread keeps polling the network. With a
+// TelemetrySink attached, every tick also publishes a metrics record.
+// ------------------------------------------------------------------------
+class SimulationThread {
+public:
+    explicit SimulationThread(Simulation &simulation, AudioService* audioService = nullptr,
+                              Lockstep* lockstepLink = nullptr, TelemetrySink* telemetrySink = nullptr)
+        : sim(simulation), audio(audioService), lockstep(lockstepLink), telemetry(telemetrySink),
+          running(false), droppedCommands(0), tickAllocs(0)
+    {
+        // So the first frame has something to draw
+        sim.WriteSnapshot(snapshots.WriteBuffer());
+        snapshots.Publish();
+    }
+
+    ~SimulationThread() { Stop(); }
+
+    void Start() {
+        if (running.exchange(true)) return;
+        worker = thread([this]() { Loop(); });
+    }
+
+    void Stop() {
+        running.store(false);
+        if (worker.joinable()) worker.join();
+    }
+
+    // ---- Main thread ----
+
+    // Queue a command for the next tick; false if the queue was full
+    bool Send(const Command &cmd) {
+        if (commands.Push(cmd)) return true;
+        droppedCommands++;
+        return false;
+    }
+
+    // Newest snapshot published by the simulation
+    const RenderSnapshot &Latest() {
+        snapshots.Acquire();
+        return snapshots.ReadBuffer();
+    }
+
+    int DroppedCommands() const { return droppedCommands; }
+    // Heap allocations made by the last loop iteration (0 in steady state)
+    int TickAllocs() const { return tickAllocs.load(memory_order_relaxed); }
+
+private:
+    void Loop() {
+        typedef chrono::steady_clock Clock;
+        const Clock::duration tickLength =
+            chrono::duration_cast<Clock::duration>(chrono::duration<float>(simTickSeconds));
+        // After a long stall, skip ahead instead of running a burst of ticks
+        const Clock::duration maxLag = tickLength * 5;
+        Clock::time_point nextTick = Clock::now();
+
+        while (running.load(memory_order_acquire)) {
+            int64_t allocsBefore = ThreadAllocCount();
+            {
+                ProfileScope scope(sim.Profile(), PHASE_COMMANDS);
+                Command cmd;
+                while (commands.Pop(cmd)) {
+                    if (lockstep) lockstep->Submit(cmd);
+                    else sim.Apply(cmd);
+                }
+            }
+            if (TryStep()) {
+                if (audio && sim.ShotsFired() > 0) audio->Post(SFX_BULLET, sim.ShotsFired());
+                sim.WriteSnapshot(snapshots.WriteBuffer());
+                snapshots.Publish();
+                if (telemetry && telemetry->IsOpen()) {
+                    TelemetryRecord record;
+                    sim.WriteTelemetry(record);
+                    record.timeNs = ProfileNow();
+                    record.heapAllocs = (int32_t)(ThreadAllocCount() - allocsBefore);
+                    telemetry->Publish(record);
+                }
+            }
+            tickAllocs.store((int)(ThreadAllocCount() - allocsBefore), memory_order_relaxed);
+
+            nextTick += tickLength;
+            Clock::time_point now = Clock::now();
+            if (now - nextTick > maxLag) nextTick = now;
+            this_thread::sleep_until(nextTick);
+        }
+    }
+
+    // Runs the next tick unless lockstep is still waiting for the peer
+    bool TryStep() {
+        if (!lockstep) {
+            sim.Step(simTickSeconds);
+            return true;
+        }
+        lockstep->Poll();
+        uint64_t next = sim.Tick() + 1;
+        if (!lockstep->Ready(next)) {
+            lockstep->NoteStall();
+            return false;
+        }
+        lockstep->ForEachCommand(next, [this](const Command &cmd) { sim.Apply(cmd); });
+        sim.Step(simTickSeconds);
+        lockstep->Advance(next, sim.Checksum());
+        return true;
+    }
+
+    Simulation &sim;
+    AudioService* audio;
+    Lockstep* lockstep;
+    TelemetrySink* telemetry;
+    SpscQueue<Command, 256> commands;
+    TripleBuffer<RenderSnapshot> snapshots;
+    atomic<bool> running;
+    int droppedCommands;
+    atomic<int> tickAllocs;
+    thread worker;
+};
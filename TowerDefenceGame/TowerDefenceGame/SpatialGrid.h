@@ -0,0 +1,183 @@
+#pragma once
+
+#include "Fixed.h"
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+// ------------------------------------------------------------------------
+// SpatialGrid: uniform-grid broad phase for radius and segment queries
+//
+// Points are staged with Insert() and packed with Build() using a counting
+// sort, so every cell is a contiguous run of entries. Build() only visits
+// the cells that hold points (and resets the ones the last build filled),
+// so its cost follows the number of points, not the size of the map. All
+// storage is reused between rebuilds, so a steady-state tick does not
+// allocate.
+// Coordinates are in tile units (x = col, y = row), as simulation Scalars.
+// ------------------------------------------------------------------------
+class SpatialGrid {
+public:
+    struct Entry {
+        Scalar x, y;
+        uint32_t id;
+    };
+
+    SpatialGrid(int worldRows, int worldCols, Scalar cell)
+        : cellSize(cell), invCellSize(Scalar(1) / cell),
+          gridCols(0), gridRows(0)
+    {
+        Resize(worldRows, worldCols);
+    }
+
+    void Resize(int worldRows, int worldCols) {
+        gridCols = max(1, (int)ceilf(worldCols / ToFloat(cellSize)));
+        gridRows = max(1, (int)ceilf(worldRows / ToFloat(cellSize)));
+        cellStart.assign(gridCols * gridRows, 0);
+        cellCount.assign(gridCols * gridRows, 0);
+        occupied.clear();
+        staged.clear();
+        entries.clear();
+    }
+
+    void Clear() {
+        staged.clear();
+    }
+
+    // Room for 'count' points, so rebuilds and queries up to that size
+    // never allocate
+    void Reserve(size_t count) {
+        staged.reserve(count);
+        stagedCell.reserve(count);
+        entries.reserve(count);
+        occupied.reserve(count);
+        segmentHits.reserve(count);
+    }
+
+    void Insert(uint32_t id, Scalar x, Scalar y) {
+        staged.push_back({x, y, id});
+    }
+
+    // Pack staged points into per-cell runs (counting sort over the
+    // occupied cells only)
+    void Build() {
+        for (size_t i = 0; i < occupied.size(); i++) cellCount[occupied[i]] = 0;
+        occupied.clear();
+        stagedCell.resize(staged.size());
+        for (size_t i = 0; i < staged.size(); i++) {
+            int cell = CellIndex(CellX(staged[i].x), CellY(staged[i].y));
+            stagedCell[i] = cell;
+            if (cellCount[cell]++ == 0) occupied.push_back(cell);
+        }
+        int start = 0;
+        for (size_t i = 0; i < occupied.size(); i++) {
+            cellStart[occupied[i]] = start;
+            start += cellCount[occupied[i]];
+        }
+        // cellStart doubles as the write cursor, then is rewound
+        entries.resize(staged.size());
+        for (size_t i = 0; i < staged.size(); i++) {
+            entries[cellStart[stagedCell[i]]++] = staged[i];
+        }
+        for (size_t i = 0; i < occupied.size(); i++) {
+            cellStart[occupied[i]] -= cellCount[occupied[i]];
+        }
+        lastTested = 0;
+    }
+
+    // Ids of all points within radius r of (x, y). Clears 'out' first.
+    // 'out' is any vector of uint32_t (usually tick-arena scratch).
+    template <typename List>
+    void QueryRadius(Scalar x, Scalar y, Scalar r, List &out) const {
+        out.clear();
+        int cx0 = CellX(x - r), cx1 = CellX(x + r);
+        int cy0 = CellY(y - r), cy1 = CellY(y + r);
+        Scalar rSqr = r * r;
+        for (int cy = cy0; cy <= cy1; cy++) {
+            for (int cx = cx0; cx <= cx1; cx++) {
+                int cell = CellIndex(cx, cy);
+                for (int i = cellStart[cell], end = i + cellCount[cell]; i < end; i++) {
+                    const Entry &e = entries[i];
+                    Scalar dx = e.x - x;
+                    Scalar dy = e.y - y;
+                    lastTested++;
+                    if (dx * dx + dy * dy <= rSqr) {
+                        out.push_back(e.id);
+                    }
+                }
+            }
+        }
+    }
+
+    // Ids of all points within distance r of the segment (x0,y0)-(x1,y1),
+    // ordered by how far along the segment they lie (ties by id, so the
+    // order does not depend on the cell layout). Clears 'out' first.
+    // Walks the cells overlapped by the capsule's bounding box, which stays
+    // small because projectiles only sweep a few pixels per tick.
+    template <typename List>
+    void QuerySegment(Scalar x0, Scalar y0, Scalar x1, Scalar y1, Scalar r, List &out) const {
+        out.clear();
+        segmentHits.clear();
+        Scalar sx = x1 - x0;
+        Scalar sy = y1 - y0;
+        Scalar lenSqr = sx * sx + sy * sy;
+        Scalar invLenSqr = lenSqr > 0 ? Scalar(1) / lenSqr : Scalar(0);
+        int cx0 = CellX(min(x0, x1) - r), cx1 = CellX(max(x0, x1) + r);
+        int cy0 = CellY(min(y0, y1) - r), cy1 = CellY(max(y0, y1) + r);
+        Scalar rSqr = r * r;
+        for (int cy = cy0; cy <= cy1; cy++) {
+            for (int cx = cx0; cx <= cx1; cx++) {
+                int cell = CellIndex(cx, cy);
+                for (int i = cellStart[cell], end = i + cellCount[cell]; i < end; i++) {
+                    const Entry &e = entries[i];
+                    Scalar t = ((e.x - x0) * sx + (e.y - y0) * sy) * invLenSqr;
+                    t = min(Scalar(1), max(Scalar(0), t));
+                    Scalar dx = x0 + sx * t - e.x;
+                    Scalar dy = y0 + sy * t - e.y;
+                    lastTested++;
+                    if (dx * dx + dy * dy <= rSqr) {
+                        segmentHits.push_back({t, e.id});
+                    }
+                }
+            }
+        }
+        sort(segmentHits.begin(), segmentHits.end(),
+             [](const SegmentHit &a, const SegmentHit &b) { return a.t < b.t || (a.t == b.t && a.id < b.id); });
+        for (size_t i = 0; i < segmentHits.size(); i++) {
+            out.push_back(segmentHits[i].id);
+        }
+    }
+
+    size_t Size() const { return entries.size(); }
+
+    // Number of points distance-tested by queries since the last Build()
+    size_t TestedSinceBuild() const { return lastTested; }
+
+private:
+    struct SegmentHit {
+        Scalar t;
+        uint32_t id;
+    };
+
+    int CellX(Scalar x) const { return min(gridCols - 1, max(0, CellFloor(x * invCellSize))); }
+    int CellY(Scalar y) const { return min(gridRows - 1, max(0, CellFloor(y * invCellSize))); }
+    // Queries may reach past the map edge, so this has to floor negatives
+    static int CellFloor(float v) { return (int)floorf(v); }
+    static int CellFloor(Fixed v) { return FloorToInt(v); }
+    int CellIndex(int cx, int cy) const { return cy * gridCols + cx; }
+
+    Scalar cellSize;
+    Scalar invCellSize;
+    int gridCols, gridRows;
+    vector<int> cellStart;      // first entry of each cell (valid while its count > 0)
+    vector<int> cellCount;      // entries per cell, zero outside 'occupied'
+    vector<int> occupied;       // cells holding points since the last Build()
+    vector<int> stagedCell;
+    vector<Entry> staged;
+    vector<Entry> entries;
+    mutable vector<SegmentHit> segmentHits;
+    mutable size_t lastTested = 0;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+using namespace std;
+
+// ------------------------------------------------------------------------
+// SpscQueue: fixed-capacity lock-free ring for one producer thread and one
+// consumer thread
+//
+// Neither side ever waits: Push() fails when the ring is full and Pop()
+// fails when it is empty, and the caller decides what to do about it.
+// Capacity must be a power of two.
+// ------------------------------------------------------------------------
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+public:
+    SpscQueue() : writePos(0), readPos(0) {}
+
+    // Producer only
+    bool Push(const T &item) {
+        size_t w = writePos.load(memory_order_relaxed);
+        if (w - readPos.load(memory_order_acquire) == Capacity) return false;
+        slots[w & (Capacity - 1)] = item;
+        writePos.store(w + 1, memory_order_release);
+        return true;
+    }
+
+    // Consumer only
+    bool Pop(T &out) {
+        size_t r = readPos.load(memory_order_relaxed);
+        if (r == writePos.load(memory_order_acquire)) return false;
+        out = slots[r & (Capacity - 1)];
+        readPos.store(r + 1, memory_order_release);
+        return true;
+    }
+
+private:
+    // Each index on its own cache line so the two threads do not false-share
+    alignas(64) atomic<size_t> writePos;
+    alignas(64) atomic<size_t> readPos;
+    alignas(64) T slots[Capacity];
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Profiler.h"
+#include "MappedFile.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// ------------------------------------------------------------------------
+// Telemetry: per-tick simulation metrics streamed to another process
+//
+// The sink is a ring of fixed-size records in a memory-mapped file, so a
+// reader process (telemetry_csv) can follow a live match. The simulation
+// thread is the only writer and the reader the only consumer; each side
+// only advances its own counter. Publishing is a copy into the mapping
+// and never blocks or allocates. When the reader falls behind and the
+// ring is full, the new record is dropped and counted as an overrun.
+//
+// File layout: TelemetryHeader, then 'capacity' TelemetryRecords.
+// ------------------------------------------------------------------------
+const uint32_t telemetryMagic = 0x544C4D54;     // "TMLT"
+const uint32_t telemetryVersion = 1;
+
+struct TelemetryRecord {
+    uint64_t tick;
+    int64_t timeNs;             // ProfileNow() when the tick finished
+    int32_t gold;
+    int32_t enemiesReached;
+    int32_t enemiesAlive;
+    int32_t projectilesAlive;   // defender and enemy bullets
+    int32_t defendersAlive;
+    float defenderHealth;       // sum over all defenders
+    int32_t heapAllocs;         // by the simulation thread during the tick
+    uint32_t overruns;          // records dropped before this one, in total
+    uint32_t phaseNs[profilePhaseCount];    // latest time of each phase
+};
+
+static_assert(sizeof(TelemetryRecord) == 48 + 4 * profilePhaseCount, "telemetry record must stay packed");
+
+struct TelemetryHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t capacity;          // records in the ring
+    uint32_t phaseCount;
+    atomic<uint32_t> closed;    // set once the writer has finished
+    alignas(64) atomic<uint64_t> written;   // records published (writer only)
+    alignas(64) atomic<uint64_t> consumed;  // records read (reader only)
+    alignas(64) atomic<uint64_t> dropped;   // records lost to a full ring (writer only)
+};
+
+static_assert(sizeof(atomic<uint64_t>) == sizeof(uint64_t), "telemetry counters must be plain words");
+
+inline TelemetryRecord* TelemetryRecords(TelemetryHeader* header) {
+    return (TelemetryRecord*)(header + 1);
+}
+
+class TelemetrySink {
+public:
+    TelemetrySink() : header(nullptr) {}
+    ~TelemetrySink() { Close(); }
+
+    // Creates 'path' with room for 'capacity' records (startup only)
+    bool Open(const char* path, uint32_t capacity) {
+        Close();
+        if (!file.Create(path, sizeof(TelemetryHeader) + (size_t)capacity * sizeof(TelemetryRecord))) {
+            return false;
+        }
+        header = (TelemetryHeader*)file.Data();
+        header->magic = telemetryMagic;
+        header->version = telemetryVersion;
+        header->recordSize = sizeof(TelemetryRecord);
+        header->capacity = capacity;
+        header->phaseCount = profilePhaseCount;
+        header->closed.store(0, memory_order_relaxed);
+        header->written.store(0, memory_order_relaxed);
+        header->consumed.store(0, memory_order_relaxed);
+        header->dropped.store(0, memory_order_release);
+        return true;
+    }
+
+    void Close() {
+        if (!header) return;
+        header->closed.store(1, memory_order_release);
+        header = nullptr;
+        file.Close();
+    }
+
+    bool IsOpen() const { return header != nullptr; }
+
+    // Writer thread only. Never blocks; a full ring drops the record, and
+    // a sink that is not open ignores it.
+    bool Publish(TelemetryRecord &record) {
+        if (!header) return false;
+        uint64_t w = header->written.load(memory_order_relaxed);
+        uint64_t dropped = header->dropped.load(memory_order_relaxed);
+        if (w - header->consumed.load(memory_order_acquire) >= header->capacity) {
+            header->dropped.store(dropped + 1, memory_order_relaxed);
+            return false;
+        }
+        record.overruns = (uint32_t)dropped;
+        TelemetryRecords(header)[w % header->capacity] = record;
+        header->written.store(w + 1, memory_order_release);
+        return true;
+    }
+
+    // Stats, readable from any thread while open
+    uint64_t Written() const { return header ? header->written.load(memory_order_relaxed) : 0; }
+    uint64_t Dropped() const { return header ? header->dropped.load(memory_order_relaxed) : 0; }
+
+private:
+    TelemetrySink(const TelemetrySink &) = delete;
+    TelemetrySink &operator=(const TelemetrySink &) = delete;
+
+    MappedFile file;
+    TelemetryHeader* header;
+};
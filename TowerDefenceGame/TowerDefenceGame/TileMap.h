@@ -0,0 +1,178 @@
+#pragma once
+
+#include "raylib.h"
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+// Tiles per chunk side. A baked chunk is chunkSize * tileSize pixels square.
+const int chunkSize = 16;
+
+// ------------------------------------------------------------------------
+// TileMap: runtime-sized map with chunked uint8_t tile storage
+//
+// Each chunk's tiles are contiguous, so baking one chunk reads a single
+// 256-byte block. Every edit bumps the chunk's version, which is how the
+// render cache knows a baked layer is stale.
+// ------------------------------------------------------------------------
+class TileMap {
+public:
+    TileMap(int mapRows, int mapCols)
+        : numRows(mapRows), numCols(mapCols),
+          chunkRows((mapRows + chunkSize - 1) / chunkSize),
+          chunkCols((mapCols + chunkSize - 1) / chunkSize),
+          tiles((size_t)chunkRows * chunkCols * chunkSize * chunkSize, 0),
+          versions((size_t)chunkRows * chunkCols, 1)
+    {}
+
+    int Rows() const { return numRows; }
+    int Cols() const { return numCols; }
+    int ChunkRows() const { return chunkRows; }
+    int ChunkCols() const { return chunkCols; }
+    bool InBounds(int r, int c) const { return r >= 0 && r < numRows && c >= 0 && c < numCols; }
+
+    uint8_t Get(int r, int c) const { return tiles[Offset(r, c)]; }
+
+    void Set(int r, int c, uint8_t id) {
+        size_t offset = Offset(r, c);
+        if (tiles[offset] == id) return;
+        tiles[offset] = id;
+        versions[ChunkIndex(r / chunkSize, c / chunkSize)]++;
+    }
+
+    int ChunkIndex(int chunkRow, int chunkCol) const { return chunkRow * chunkCols + chunkCol; }
+    uint32_t ChunkVersion(int chunk) const { return versions[chunk]; }
+
+private:
+    size_t Offset(int r, int c) const {
+        size_t chunk = (size_t)ChunkIndex(r / chunkSize, c / chunkSize);
+        return (chunk * chunkSize + r % chunkSize) * chunkSize + c % chunkSize;
+    }
+
+    int numRows, numCols;
+    int chunkRows, chunkCols;
+    vector<uint8_t> tiles;
+    vector<uint32_t> versions;
+};
+
+// ------------------------------------------------------------------------
+// ChunkRenderCache: baked render layers for the chunks in view
+//
+// Holds a fixed pool of render textures sized for the most chunks the
+// camera can show at its minimum zoom, recycled least-recently-used. GPU
+// memory depends only on the view, never on the map size. Call Prepare()
+// outside BeginMode2D (baking switches render targets), then Draw() inside.
+// ------------------------------------------------------------------------
+class ChunkRenderCache {
+public:
+    ChunkRenderCache(const TileMap &tileMap, int viewW, int viewH, float minZoom, int tilePixels)
+        : map(tileMap), tilePx(tilePixels), chunkPx(chunkSize * tilePixels), frame(0),
+          slotOfChunk((size_t)tileMap.ChunkRows() * tileMap.ChunkCols(), -1)
+    {
+        int across = (int)ceilf(viewW / (chunkPx * minZoom)) + 1;
+        int down = (int)ceilf(viewH / (chunkPx * minZoom)) + 1;
+        slots.resize(min(across * down, (int)slotOfChunk.size()));
+        for (size_t i = 0; i < slots.size(); i++) {
+            slots[i].target = LoadRenderTexture(chunkPx, chunkPx);
+            slots[i].chunk = -1;
+            slots[i].version = 0;
+            slots[i].lastUsed = 0;
+        }
+    }
+
+    ~ChunkRenderCache() {
+        for (size_t i = 0; i < slots.size(); i++) {
+            UnloadRenderTexture(slots[i].target);
+        }
+    }
+
+    // Bake every visible chunk that is missing or stale. 'tileTextures' is
+    // indexed by tile id; ids with no texture (id == 0) are left empty.
+    void Prepare(Rectangle view, const Texture2D* tileTextures) {
+        frame++;
+        VisibleRange(view, r0, c0, r1, c1);
+        for (int cr = r0; cr <= r1; cr++) {
+            for (int cc = c0; cc <= c1; cc++) {
+                int chunk = map.ChunkIndex(cr, cc);
+                int slot = slotOfChunk[chunk];
+                if (slot < 0) {
+                    slot = Evict();
+                    slotOfChunk[chunk] = slot;
+                    slots[slot].chunk = chunk;
+                    slots[slot].version = 0;
+                }
+                slots[slot].lastUsed = frame;
+                if (slots[slot].version != map.ChunkVersion(chunk)) {
+                    Bake(slots[slot], cr, cc, tileTextures);
+                }
+            }
+        }
+    }
+
+    // Draw the chunks found by the last Prepare(), in world coordinates
+    void Draw() const {
+        Rectangle flipped = { 0.0f, 0.0f, (float)chunkPx, -(float)chunkPx };
+        for (int cr = r0; cr <= r1; cr++) {
+            for (int cc = c0; cc <= c1; cc++) {
+                const Slot &slot = slots[slotOfChunk[map.ChunkIndex(cr, cc)]];
+                Vector2 pos = { (float)(cc * chunkPx), (float)(cr * chunkPx) };
+                DrawTextureRec(slot.target.texture, flipped, pos, WHITE);
+            }
+        }
+    }
+
+    int VisibleChunks() const { return (r1 - r0 + 1) * (c1 - c0 + 1); }
+
+private:
+    struct Slot {
+        RenderTexture2D target;
+        int chunk;
+        uint32_t version;
+        uint64_t lastUsed;
+    };
+
+    void VisibleRange(Rectangle view, int &outR0, int &outC0, int &outR1, int &outC1) const {
+        outC0 = max(0, (int)floorf(view.x / chunkPx));
+        outR0 = max(0, (int)floorf(view.y / chunkPx));
+        outC1 = min(map.ChunkCols() - 1, (int)floorf((view.x + view.width) / chunkPx));
+        outR1 = min(map.ChunkRows() - 1, (int)floorf((view.y + view.height) / chunkPx));
+        // Never ask for more chunks than the pool holds
+        outR1 = min(outR1, outR0 + (int)slots.size() / max(1, outC1 - outC0 + 1) - 1);
+    }
+
+    int Evict() {
+        size_t oldest = 0;
+        for (size_t i = 1; i < slots.size(); i++) {
+            if (slots[i].lastUsed < slots[oldest].lastUsed) oldest = i;
+        }
+        if (slots[oldest].chunk >= 0) slotOfChunk[slots[oldest].chunk] = -1;
+        return (int)oldest;
+    }
+
+    void Bake(Slot &slot, int chunkRow, int chunkCol, const Texture2D* tileTextures) {
+        BeginTextureMode(slot.target);
+        ClearBackground(BLANK);
+        int rowEnd = min(chunkSize, map.Rows() - chunkRow * chunkSize);
+        int colEnd = min(chunkSize, map.Cols() - chunkCol * chunkSize);
+        for (int r = 0; r < rowEnd; r++) {
+            for (int c = 0; c < colEnd; c++) {
+                uint8_t id = map.Get(chunkRow * chunkSize + r, chunkCol * chunkSize + c);
+                if (tileTextures[id].id == 0) continue;
+                DrawTexture(tileTextures[id], c * tilePx, r * tilePx, WHITE);
+            }
+        }
+        EndTextureMode();
+        slot.version = map.ChunkVersion(slot.chunk);
+    }
+
+    const TileMap &map;
+    int tilePx;
+    int chunkPx;
+    uint64_t frame;
+    vector<int> slotOfChunk;
+    vector<Slot> slots;
+    int r0 = 0, c0 = 0, r1 = -1, c1 = -1;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+
+using namespace std;
+
+// ------------------------------------------------------------------------
+// TripleBuffer: lock-free hand-off of whole snapshots from one writer
+// thread to one reader thread
+//
+// The writer fills WriteBuffer() and calls Publish(); the reader calls
+// Acquire() and reads ReadBuffer(). The three slots are swapped through
+// one atomic index, so neither side ever waits for the other. The reader
+// always sees the newest complete snapshot (older unread ones are simply
+// overwritten). Slots are reused, so vectors inside T keep their capacity.
+// ------------------------------------------------------------------------
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : back(0), shared(1), front(2) {}
+
+    // Writer only
+    T &WriteBuffer() { return slots[back]; }
+
+    void Publish() {
+        back = shared.exchange(back | freshBit, memory_order_acq_rel) & indexMask;
+    }
+
+    // Reader only. Swaps in the newest snapshot; false if nothing new.
+    bool Acquire() {
+        if (!(shared.load(memory_order_relaxed) & freshBit)) return false;
+        front = shared.exchange(front, memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    const T &ReadBuffer() const { return slots[front]; }
+
+private:
+    static const int indexMask = 3;
+    static const int freshBit = 4;
+
+    T slots[3];
+    int back;
+    atomic<int> shared;
+    int front;
+};
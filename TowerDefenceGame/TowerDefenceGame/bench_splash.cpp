@@ -0,0 +1,309 @@
+// ------------------------------------------------------------------------
+// Splash-heavy stress benchmark for the projectile broad phase
+//
+// Keeps a fixed number of enemies and projectiles alive on a large field
+// (killed enemies respawn, spent bullets are re-fired). Enemies crowd into
+// dense blobs and every shot is aimed at one, so a splash typically
+// catches over a dozen enemies. Times the grid rebuild plus
+// UpdateProjectiles per tick, next to a brute-force version that scans
+// every enemy for each contact and splash. Both runs start from
+// the same wave and apply the same rules, so their kill counts must match;
+// the benchmark exits with an error if they do not. Heap allocations are
+// counted too: once warmed up, a tick must not allocate, and the benchmark
+// fails if one does. The grid run is repeated with the grid sized for a
+// far larger map: the wave is the same, so kills must match again, and
+// the tick must cost about the same, since grid work should follow the
+// number of enemies rather than the map area. Builds in either number mode
+// (make bench FIXED_POINT=TRUE for the fixed-point simulation).
+//
+//   bench_splash [enemies] [projectiles] [ticks]
+// ------------------------------------------------------------------------
+#include "GameObjects.h"
+#include "SpatialGrid.h"
+#include "Projectiles.h"
+#include "Arena.h"
+#include "Memory.h"
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+const int fieldRows = 256;
+const int fieldCols = 256;
+// Map for the size check; the wave still only covers fieldRows x fieldCols
+const int largeRows = 2048;
+const int largeCols = 2048;
+// Allowed large-map tick cost: small-map cost times the ratio plus slack (ms)
+const double largeMapCostRatio = 1.5;
+const double largeMapSlackMs = 0.05;
+const Scalar tickDelta = 1.0f / 60.0f;
+// Enemies spawn within blobRadius tiles of one of blobCount centres; shots
+// start 4-10 tiles from a centre and head for it
+const int blobCount = 32;
+const float blobRadius = 3.0f;
+// Ticks before allocations count, so vectors can grow to their working size
+const int warmupTicks = 60;
+
+const int wizard = (int)DefenderType::WIZARD;
+const int archer = (int)DefenderType::ARCHER;
+
+struct StressWave {
+    Buckets<Enemy, enemyTypeCount> enemies;
+    Buckets<Bullet, defenderTypeCount> bullets;
+    uint32_t nextId = 1;
+    mt19937 rng;
+    float blobRow[blobCount], blobCol[blobCount];
+
+    // Centres leave room on the right for the enemies' drift
+    explicit StressWave(unsigned seed) : rng(seed) {
+        for (int b = 0; b < blobCount; b++) {
+            blobRow[b] = Uniform(16.0f, fieldRows - 16.0f);
+            blobCol[b] = Uniform(16.0f, fieldCols - 64.0f);
+        }
+    }
+
+    float Uniform(float lo, float hi) {
+        return uniform_real_distribution<float>(lo, hi)(rng);
+    }
+
+    int Blob() {
+        return uniform_int_distribution<int>(0, blobCount - 1)(rng);
+    }
+
+    void SpawnEnemy(int type) {
+        Enemy e = MakeEnemy(type, nextId++);
+        int b = Blob();
+        float angle = Uniform(0.0f, 6.2831853f);
+        float radius = blobRadius * sqrtf(Uniform(0.0f, 1.0f));    // even over the disc
+        e.row = blobRow[b] + radius * sinf(angle);
+        e.col = blobCol[b] + radius * cosf(angle);
+        enemies[type].push_back(e);
+    }
+
+    template <int T>
+    void FireBullet() {
+        int b = Blob();
+        float angle = Uniform(0.0f, 6.2831853f);
+        float distance = Uniform(4.0f, 10.0f);
+        SimVec2 origin = { Scalar((blobCol[b] + 0.5f + distance * cosf(angle)) * tileSize),
+                           Scalar((blobRow[b] + 0.5f + distance * sinf(angle)) * tileSize) };
+        float heading = angle + 3.1415927f + Uniform(-0.2f, 0.2f);
+        SimVec2 direction = { Scalar(cosf(heading)), Scalar(sinf(heading)) };
+        FireProjectile<T>(bullets[T], origin, direction);
+    }
+
+    // Drift enemies, then top both populations back up. Four in five
+    // projectiles are wizard splash, the rest archer pierce.
+    void Refill(int enemyCount, int bulletCount) {
+        for (int t = 0; t < enemyTypeCount; t++) {
+            vector<Enemy> &bucket = enemies[t];
+            for (size_t i = 0; i < bucket.size(); i++) {
+                Scalar col = bucket[i].col + enemyArchetypes[t].speed * tickDelta;
+                bucket[i].col = min(Scalar(fieldCols - 1), max(Scalar(0), col));
+            }
+            bucket.erase(remove_if(bucket.begin(), bucket.end(),
+                [](const Enemy &e) { return !e.isAlive; }), bucket.end());
+            while ((int)bucket.size() < enemyCount / enemyTypeCount) SpawnEnemy(t);
+        }
+        int splashCount = bulletCount * 4 / 5;
+        while ((int)bullets[wizard].size() < splashCount) FireBullet<wizard>();
+        while ((int)bullets[archer].size() < bulletCount - splashCount) FireBullet<archer>();
+    }
+};
+
+// Within r of each other; the box test first keeps field-wide distances
+// from being squared, which would overflow in fixed point
+inline bool Near(Scalar dx, Scalar dy, Scalar r) {
+    return ScalarAbs(dx) <= r && ScalarAbs(dy) <= r && dx * dx + dy * dy <= r * r;
+}
+
+// Splashes and the live enemies they caught, counted by the reference
+long splashes = 0;
+long splashVictims = 0;
+
+// An enemy touched by a bullet's sweep, 't' along the path
+struct Contact {
+    Scalar t;
+    uint32_t handle;
+};
+
+// Reference: the same rules as UpdateProjectileBucket (swept capsule,
+// contacts in path order, splash around the struck enemy), but every
+// query scans all enemies instead of the grid. Any difference in kills
+// is a broad-phase bug. 'contacts' is reused between calls.
+template <int T>
+int BruteForceBucket(vector<Bullet> &bucket, Buckets<Enemy, enemyTypeCount> &enemies, Scalar deltaTime,
+                     Scalar worldW, Scalar worldH, vector<Contact> &contacts)
+{
+    constexpr ProjectileKind kind = defenderArchetypes[T].projectile;
+    constexpr Scalar damage = defenderArchetypes[T].damage;
+    constexpr Scalar splashRadius = defenderArchetypes[T].splashRadius;
+    const Scalar invTile = 1.0f / tileSize;
+    const Scalar r = projectileHitRadius;
+    int kills = 0;
+    for (size_t i = 0; i < bucket.size(); i++) {
+        Bullet &b = bucket[i];
+        Scalar x0 = b.position.x * invTile, y0 = b.position.y * invTile;
+        b.position.x += b.velocity.x * deltaTime;
+        b.position.y += b.velocity.y * deltaTime;
+        if (b.position.x < 0 || b.position.x > worldW || b.position.y < 0 || b.position.y > worldH) {
+            b.active = false;
+            continue;
+        }
+        Scalar x1 = b.position.x * invTile, y1 = b.position.y * invTile;
+        Scalar sx = x1 - x0, sy = y1 - y0;
+        Scalar lenSqr = sx * sx + sy * sy;
+        Scalar invLenSqr = lenSqr > 0 ? Scalar(1) / lenSqr : Scalar(0);
+        contacts.clear();
+        for (int t = 0; t < enemyTypeCount; t++) {
+            for (size_t j = 0; j < enemies[t].size(); j++) {
+                const Enemy &e = enemies[t][j];
+                if (!e.isAlive) continue;
+                Scalar ex = e.col + 0.5f, ey = e.row + 0.5f;
+                // Outside the capsule's bounding box cannot touch it
+                if (ex < min(x0, x1) - r || ex > max(x0, x1) + r ||
+                    ey < min(y0, y1) - r || ey > max(y0, y1) + r) continue;
+                Scalar along = ((ex - x0) * sx + (ey - y0) * sy) * invLenSqr;
+                along = min(Scalar(1), max(Scalar(0), along));
+                if (Near(x0 + sx * along - ex, y0 + sy * along - ey, r)) {
+                    contacts.push_back({along, EnemyHandle(t, j)});
+                }
+            }
+        }
+        sort(contacts.begin(), contacts.end(), [](const Contact &a, const Contact &c) {
+            return a.t < c.t || (a.t == c.t && a.handle < c.handle);
+        });
+
+        if (kind == ProjectileKind::PIERCE) {
+            for (size_t h = 0; h < contacts.size() && b.pierceLeft > 0; h++) {
+                Enemy &e = EnemyAt(enemies, contacts[h].handle);
+                if (!e.isAlive) continue;
+                EnemyTag tag = (EnemyTag)e.id;
+                if (find(b.hitIds, b.hitIds + b.hitCount, tag) != b.hitIds + b.hitCount) continue;
+                DamageEnemy(e, damage, kills);
+                b.hitIds[b.hitCount++] = tag;
+                b.pierceLeft--;
+            }
+            if (b.pierceLeft <= 0) b.active = false;
+        } else {
+            Enemy* struck = nullptr;
+            for (size_t h = 0; h < contacts.size() && !struck; h++) {
+                Enemy &e = EnemyAt(enemies, contacts[h].handle);
+                if (e.isAlive) struck = &e;
+            }
+            if (!struck) continue;
+            b.active = false;
+            if (kind == ProjectileKind::SPLASH) {
+                Scalar cx = struck->col + 0.5f, cy = struck->row + 0.5f;
+                splashes++;
+                for (int u = 0; u < enemyTypeCount; u++) {
+                    for (size_t k = 0; k < enemies[u].size(); k++) {
+                        Enemy &o = enemies[u][k];
+                        if (!o.isAlive || !Near(o.col + 0.5f - cx, o.row + 0.5f - cy, splashRadius)) continue;
+                        splashVictims++;
+                        DamageEnemy(o, damage, kills);
+                    }
+                }
+            } else {
+                DamageEnemy(*struck, damage, kills);
+            }
+        }
+    }
+    bucket.erase(remove_if(bucket.begin(), bucket.end(),
+        [](const Bullet &b) { return !b.active; }), bucket.end());
+    return kills;
+}
+
+struct Timing {
+    double totalMs = 0.0;
+    double worstMs = 0.0;
+    long kills = 0;
+    int64_t steadyAllocs = 0;   // heap allocations after warm-up
+};
+
+template <typename StepFn>
+Timing RunWave(int enemyCount, int bulletCount, int ticks, StepFn step) {
+    StressWave wave(1234);
+    wave.Refill(enemyCount, bulletCount);
+    Timing t;
+    for (int i = 0; i < ticks; i++) {
+        int64_t allocsBefore = AllocCountTotal();
+        auto start = chrono::steady_clock::now();
+        t.kills += step(wave);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        t.totalMs += ms;
+        t.worstMs = max(t.worstMs, ms);
+        wave.Refill(enemyCount, bulletCount);
+        if (i >= warmupTicks) t.steadyAllocs += AllocCountTotal() - allocsBefore;
+    }
+    return t;
+}
+
+int main(int argc, char** argv) {
+    int enemyCount  = argc > 1 ? atoi(argv[1]) : 5000;
+    int bulletCount = argc > 2 ? atoi(argv[2]) : 500;
+    int ticks       = argc > 3 ? atoi(argv[3]) : 600;
+    const Scalar worldW = fieldCols * tileSize;
+    const Scalar worldH = fieldRows * tileSize;
+
+    SpatialGrid grid(fieldRows, fieldCols, 2.0f);
+    SpatialGrid largeGrid(largeRows, largeCols, 2.0f);
+    grid.Reserve(enemyCount);
+    largeGrid.Reserve(enemyCount);
+    TickArena arena(64 * 1024);
+    size_t tested = 0;
+
+    auto gridStep = [&](SpatialGrid &g) {
+        return [&](StressWave &w) {
+            ArenaScope scratch(arena);
+            RebuildEnemyGrid(g, w.enemies);
+            HitList hits(arena);
+            int kills = UpdateProjectiles(w.bullets, w.enemies, g, tickDelta, worldW, worldH, hits);
+            tested += g.TestedSinceBuild();
+            return kills;
+        };
+    };
+    Timing gridTiming = RunWave(enemyCount, bulletCount, ticks, gridStep(grid));
+    size_t smallTested = tested;
+    Timing largeTiming = RunWave(enemyCount, bulletCount, ticks, gridStep(largeGrid));
+    tested = smallTested;
+    vector<Contact> contacts;
+    contacts.reserve(enemyCount);
+    Timing bruteTiming = RunWave(enemyCount, bulletCount, ticks, [&](StressWave &w) {
+        int kills = 0;
+        ForEachArchetype<defenderTypeCount>([&](auto t) {
+            kills += BruteForceBucket<decltype(t)::value>(w.bullets[t], w.enemies, tickDelta, worldW, worldH, contacts);
+        });
+        return kills;
+    });
+
+    printf("splash wave: %d enemies, %d projectiles, %d ticks on %dx%d tiles\n",
+           enemyCount, bulletCount, ticks, fieldRows, fieldCols);
+    printf("  %-12s %10s %10s %10s\n", "", "avg ms", "worst ms", "kills");
+    printf("  %-12s %10.4f %10.4f %10ld\n", "grid", gridTiming.totalMs / ticks, gridTiming.worstMs, gridTiming.kills);
+    printf("  %-12s %10.4f %10.4f %10ld\n", "brute force", bruteTiming.totalMs / ticks, bruteTiming.worstMs, bruteTiming.kills);
+    printf("  %-12s %10.4f %10.4f %10ld  (grid for %dx%d tiles)\n", "grid, large", largeTiming.totalMs / ticks,
+           largeTiming.worstMs, largeTiming.kills, largeRows, largeCols);
+    printf("  grid distance tests per tick: %.1f (brute force: >= %d)\n",
+           (double)tested / ticks, enemyCount * bulletCount);
+    printf("  splashes: %ld, enemies caught per splash: %.1f\n",
+           splashes, splashes > 0 ? (double)splashVictims / splashes : 0.0);
+    printf("  heap allocations after %d warm-up ticks: grid %lld, brute force %lld (arena peak %d bytes)\n",
+           warmupTicks, (long long)gridTiming.steadyAllocs, (long long)bruteTiming.steadyAllocs,
+           (int)arena.Peak());
+    if (gridTiming.kills != bruteTiming.kills || largeTiming.kills != gridTiming.kills) {
+        printf("FAIL: grid and brute force disagree on kills\n");
+        return 1;
+    }
+    if (largeTiming.totalMs / ticks > gridTiming.totalMs / ticks * largeMapCostRatio + largeMapSlackMs) {
+        printf("FAIL: tick cost grows with map size\n");
+        return 1;
+    }
+    if (gridTiming.steadyAllocs > 0 || largeTiming.steadyAllocs > 0 || bruteTiming.steadyAllocs > 0) {
+        printf("FAIL: steady-state ticks allocated\n");
+        return 1;
+    }
+    return 0;
+}
@@ -4,135 +4,38 @@
 #include <vector>  
 #include <algorithm>
 #include <cmath>
+#include "GameObjects.h"
+#include "Archetypes.h"
+#include "TileMap.h"
+#include "Simulation.h"
+#include "SimulationThread.h"
+#include "Lockstep.h"
+#include "Hud.h"
+#include "Input.h"
+#include "Profiler.h"
+#include "Audio.h"
+#include "Memory.h"
+#include <cstdlib>
+#include <ctime>
 
 using namespace std;
 
 // ------------------------------------------------------------------------
-// Global Constants (same as your code)
-// ------------------------------------------------------------------------
-const int rows = 16;
-const int cols = 22;
-const int tileSize = 32;
-
-// ------------------------------------------------------------------------
-// Defender Types
-// ------------------------------------------------------------------------
-enum class DefenderType {
-    KNIGHT,
-    WIZARD,
-    ARCHER
-};
-
-// ------------------------------------------------------------------------
-// New: Enemy Types
-// ------------------------------------------------------------------------
-enum class EnemyType {
-    GOBLIN,
-    ORC
-};
-
-// ------------------------------------------------------------------------
-// Player
-// ------------------------------------------------------------------------
-struct Player {
-    float gold;
-
-    Player(float g) : gold(g) {}
-};
-
-// ------------------------------------------------------------------------
-// Game Objects as Classes (using pointers)
-// ------------------------------------------------------------------------
-class Defender {
-public:
-    DefenderType type;
-    float row, col;
-    float range;
-    float attackCooldown;
-    float attackTimer;
-    float cost;
-    float maxHealth;
-    float currentHealth;
-
-    Defender(float c)
-        : type(DefenderType::KNIGHT),
-          row(0), col(0),
-          range(3.0f),
-          attackCooldown(1.0f),
-          attackTimer(1.0f), // so it fires immediately
-          cost(c),
-          maxHealth(100.0f),
-          currentHealth(100.0f)
-    {}
-};
-
-class Enemy {
-public:
-    float row, col;
-    int currentWaypoint;
-    float speed;
-    bool isAlive;
-    bool hasActiveBullet;
-    Texture2D texture;
-    EnemyType type;    // New enemy type
-    float health;      // Health value for the enemy
-
-    // Modified constructor based on enemy type
-    Enemy(EnemyType t)
-        : row(0), col(0),
-          currentWaypoint(0),
-          speed(2.0f),
-          isAlive(true),
-          hasActiveBullet(false),
-          texture({0}),
-          type(t),
-          health(100.0f)
-    {
-        if (type == EnemyType::GOBLIN) {
-            speed = 2.0f;    // Goblins are faster
-            health = 50.0f;  // Goblins have lower health
-        } else { // ORC
-            speed = 1.0f;    // Orcs are slower
-            health = 150.0f; // Orcs have higher health
-        }
-    }
-};
-
-struct Bullet {
-    Vector2 position;
-    Vector2 velocity;
-    bool active;
-};
-
-struct EnemyBullet {
-    Vector2 position;
-    Vector2 velocity;
-    bool active;
-    // pointer to the enemy that fired it
-    Enemy* owner;
-};
-
-// ------------------------------------------------------------------------
-// TowerDefenseGame Class (Encapsulates game state, logic, drawing)
+// TowerDefenseGame Class (window, input and drawing)
+//
+// The game state lives in a Simulation ticking on its own thread. This
+// class runs on the main thread: it turns input into commands and draws
+// whatever snapshot the simulation published last.
 // ------------------------------------------------------------------------
 class TowerDefenseGame {
 public:
-    // Game state objects
-    Player* player;
-    vector<Defender*> defenders;
-    vector<Enemy*> enemies;
-    vector<Bullet*> bullets;
-    vector<EnemyBullet*> enemyBullets;
-    Music backgroundMusic;
-
-    // Map and game variables
-    int map[rows][cols];
-    bool gameOver;
-    int enemiesReached;
-    int totalEnemiesToSpawn;
-    int spawnedEnemiesCount;
-    float spawnTimer;
-    const float spawnDelay;
+    Simulation sim;
+    AudioService audio;
+    Lockstep* lockstep;     // null in single player
+    TelemetrySink telemetry;    // open only with --telemetry
+    SimulationThread simThread;
+    InputLayer input;
+    float worldWidth, worldHeight;
 
     // Textures
     Texture2D pathTexture, torchTexture, leftColumnTexture, rightColumnTexture;
@@ -142,70 +45,67 @@ public:
     Texture2D doorRightTexture, doorLeftTexture, dotBrickTexture, dotBrickTexture2;
     Texture2D brickBlockCurve3Texture, brickBlockCurve4Texture, brickBlockCurve5Texture;
     Texture2D brick1;
-    Texture2D enemyTexture, knightTexture, wizardTexture, archerTexture;
+    Texture2D enemyTexture;
     Texture2D defenderPath, bulletTexture;
     Texture2D bigHeartTexture, fullHeartTexture, halfHeartTexture, emptyHeartTexture;
-    // New enemy textures
-    Texture2D goblinTexture, orcTexture;
+    // Map tile textures, indexed by tile id (id 0 draws nothing)
+    Texture2D tileTextures[256];
+    // Unit textures, indexed by archetype row
+    Texture2D defenderTextures[defenderTypeCount];
+    Texture2D enemyTextures[enemyTypeCount];
+
+    // How each snapshot sprite id is drawn
+    struct SpriteDraw {
+        Texture2D texture;
+        Vector2 offset;     // pixels, added to the sprite position
+        float scale;
+    };
+    SpriteDraw sprites[spriteCount];
 
     int screenWidth, screenHeight;
     DefenderType selectedDefenderType;
+    HudLayer* hud;
+
+    // Profiler overlay (F3) and the newest placement already seen on screen
+    bool showProfiler;
+    int64_t lastPlacedAt;
 
-    // Enemy path 
-    vector<Vector2> enemyPathRC;
+    // Scrolling, zoomable view of the world; the map is drawn from baked chunks
+    Camera2D camera;
+    const float minZoom, maxZoom;
+    ChunkRenderCache* chunkCache;
 
     // --------------------------------------------------------------------
-    // Constructor: initialize game state, load textures, set up map
+    // Constructor: set up the simulation, load textures
     // --------------------------------------------------------------------
-    TowerDefenseGame()
-        : player(nullptr), defenders(), enemies(), bullets(), enemyBullets(),
-          gameOver(false), enemiesReached(10), totalEnemiesToSpawn(20),
-          spawnedEnemiesCount(0), spawnTimer(0.0f), spawnDelay(2.0f), // spawn delay now 2 sec
-          selectedDefenderType(DefenderType::KNIGHT)
+    // With 'link' set (the game takes ownership), it runs in lockstep with
+    // that peer; with 'telemetryPath' set, per-tick metrics stream to that file
+    TowerDefenseGame(int roomsDown = 1, int roomsAcross = 1, uint32_t seed = 1,
+                     Lockstep* link = nullptr, const char* telemetryPath = nullptr)
+        : sim(roomsDown, roomsAcross, seed), audio("Assets/BackGroundMusic(2).mp3"),
+          lockstep(link),
+          simThread(sim, &audio, lockstep, &telemetry), input(sim.Map()),
+          worldWidth(sim.WorldWidth()), worldHeight(sim.WorldHeight()),
+          selectedDefenderType(DefenderType::KNIGHT),
+          hud(nullptr), showProfiler(false), lastPlacedAt(0),
+          minZoom(0.5f), maxZoom(2.0f), chunkCache(nullptr)
     {
-        // Copy your original map layout
-        int tempMap[rows][cols] = {
-            {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
-            {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
-            {1,1,5,2,7,2,7,2,7,2,7,2,7,7,7,2,7,2,6,1,1,1},
-            {1,1,3,22,22,22,22,22,22,22,22,22,22,22,22,22,22,22,4,1,1,1},
-            {1,1,3,22,22,22,22,22,22,22,22,22,22,22,22,22,22,22,4,1,1,1},
-            {1,1,8,8,8,8,8,8,8,12,15,22,20,8,8,8,15,22,4,1,1,1},
-            {1,1,11,11,11,11,11,11,11,16,3,22,4,17,11,16,3,22,4,1,1,1},
-            {1,1,3,22,22,22,22,22,22,4,3,22,4,3,22,4,3,22,4,1,1,1},
-            {1,1,3,22,22,22,22,22,22,4,3,22,4,3,22,4,3,22,4,1,1,1},
-            {1,1,3,22,22,22,22,22,22,4,9,8,10,3,22,4,3,22,4,1,1,1},
-            {1,1,3,22,22,22,22,22,22,18,11,11,11,19,22,4,3,22,4,1,1,1},
-            {1,1,3,22,22,22,22,22,22,22,22,22,22,22,22,4,3,22,4,1,1,1},
-            {1,1,3,22,22,22,22,22,22,22,22,22,22,22,22,4,3,22,4,1,1,1},
-            {1,1,9,8,8,8,8,8,8,8,8,8,8,8,8,14,13,8,10,1,1,1},
-            {1,1,21,21,21,21,1,1,1,1,1,1,1,1,1,21,21,21,21,1,1,1},
-            {1,1,21,21,21,21,1,1,1,1,1,1,1,1,1,21,21,21,21,1,1,1}
-        };
-        for (int r = 0; r < rows; r++) {
-            for (int c = 0; c < cols; c++) {
-                map[r][c] = tempMap[r][c];
-            }
+        // The window shows one room at 1x zoom, as before
+        screenWidth = roomCols * tileSize;
+        screenHeight = roomRows * tileSize;
+        camera.offset = { 0.0f, 0.0f };
+        camera.target = { 0.0f, 0.0f };
+        camera.rotation = 0.0f;
+        camera.zoom = 1.0f;
+
+        // Opened before the simulation thread starts publishing into it; the
+        // thread skips a sink that stays closed
+        if (telemetryPath && !telemetry.Open(telemetryPath, 4096)) {
+            TraceLog(LOG_WARNING, "TELEMETRY: could not create %s", telemetryPath);
         }
 
-        // Set up enemy path 
-        enemyPathRC.push_back({6, 1});
-        enemyPathRC.push_back({6, 10});
-        enemyPathRC.push_back({7, 10});
-        enemyPathRC.push_back({8, 10});
-        enemyPathRC.push_back({10, 10});
-        enemyPathRC.push_back({10, 13});
-        enemyPathRC.push_back({6, 13});
-        enemyPathRC.push_back({6, 15});
-        enemyPathRC.push_back({12, 15});
-
-        screenWidth = cols * tileSize;
-        screenHeight = rows * tileSize;
-
         InitWindow(screenWidth, screenHeight, "Tower Defense Game");
-        InitAudioDevice();
-        backgroundMusic = LoadMusicStream("Assets/BackGroundMusic(2).mp3");
-        PlayMusicStream(backgroundMusic);
+        audio.Start();
         SetTargetFPS(60);
 
         // Load textures (same as your original calls)
@@ -231,38 +131,72 @@ public:
         brickBlockCurve5Texture = LoadTexture("Assets/brickblokcurve5.png");
         brick1 = LoadTexture("Assets/brick1.png");
         enemyTexture = LoadTexture("Assets/enemy.png"); // fallback texture if needed
-        knightTexture = LoadTexture("Assets/knight.png");
-        wizardTexture = LoadTexture("Assets/wizzard.png");
-        archerTexture = LoadTexture("Assets/archer.png");
         defenderPath = LoadTexture("Assets/DefenderPath.png");
         bulletTexture = LoadTexture("Assets/DefenderBullet.png");
         bigHeartTexture = LoadTexture("Assets/DefenderFullHealth.png");
         fullHeartTexture = LoadTexture("Assets/DefenderFullHealth.png");
         halfHeartTexture = LoadTexture("Assets/DefenderHalfHealth.png");
         emptyHeartTexture = LoadTexture("Assets/DefenderHealthDead.png");
-        goblinTexture = LoadTexture("Assets/Enemy2.png");
-        orcTexture = LoadTexture("Assets/Enemy.png");
+        for (int t = 0; t < defenderTypeCount; t++) {
+            defenderTextures[t] = LoadTexture(defenderArchetypes[t].texturePath);
+        }
+
+        for (int id = 0; id < 256; id++) {
+            tileTextures[id] = { 0 };
+        }
+        tileTextures[1] = pathTexture;
+        tileTextures[2] = torchTexture;
+        tileTextures[3] = leftColumnTexture;
+        tileTextures[4] = rightColumnTexture;
+        tileTextures[5] = wallTopLeftTexture;
+        tileTextures[6] = wallTopRightTexture;
+        tileTextures[7] = brickWallTexture;
+        tileTextures[8] = bottomWallTexture;
+        tileTextures[9] = bottomLeftBrickTexture;
+        tileTextures[10] = bottomRightBrickTexture;
+        tileTextures[11] = bottomWall2Texture;
+        tileTextures[12] = brickBlockCurveTexture;
+        tileTextures[13] = doorRightTexture;
+        tileTextures[14] = doorLeftTexture;
+        tileTextures[15] = brickBlockCurveTexture2;
+        tileTextures[16] = dotBrickTexture;
+        tileTextures[17] = dotBrickTexture2;
+        tileTextures[18] = brickBlockCurve3Texture;
+        tileTextures[19] = brickBlockCurve4Texture;
+        tileTextures[20] = brickBlockCurve5Texture;
+        tileTextures[21] = brick1;
+        tileTextures[22] = defenderPath;
+        chunkCache = new ChunkRenderCache(sim.Map(), screenWidth, screenHeight, minZoom, tileSize);
+        for (int t = 0; t < enemyTypeCount; t++) {
+            enemyTextures[t] = LoadTexture(enemyArchetypes[t].texturePath);
+        }
 
-        player = new Player(9999.0f);
+        // Defenders are scaled into their tile and stand on its bottom edge
+        for (int t = 0; t < defenderTypeCount; t++) {
+            Texture2D tex = defenderTextures[t];
+            float defScale = (float)tileSize / (tex.width * 1.25f);
+            sprites[spriteDefender + t] = { tex, { (tileSize - tex.width * defScale) * 0.5f,
+                                                   tileSize - tex.height * defScale }, defScale };
+        }
+        for (int t = 0; t < enemyTypeCount; t++) {
+            sprites[spriteEnemy + t] = { enemyTextures[t], { 0.0f, 0.0f }, 1.0f };
+        }
+        sprites[spriteBullet] = { bulletTexture, { -bulletTexture.width * 0.5f, -bulletTexture.height * 0.5f }, 1.0f };
+        sprites[spriteHeartFull] = { fullHeartTexture, { 0.0f, 0.0f }, (float)tileSize / fullHeartTexture.width };
+        sprites[spriteHeartHalf] = { halfHeartTexture, { 0.0f, 0.0f }, (float)tileSize / halfHeartTexture.width };
+        sprites[spriteHeartEmpty] = { emptyHeartTexture, { 0.0f, 0.0f }, (float)tileSize / emptyHeartTexture.width };
+
+        BuildHud();
     }
 
     // --------------------------------------------------------------------
-    // Destructor: free dynamically allocated objects and unload textures
+    // Destructor: stop the simulation, free objects and unload textures
     // --------------------------------------------------------------------
     ~TowerDefenseGame() {
-        for (size_t i = 0; i < defenders.size(); i++) {
-            delete defenders[i];
-        }
-        for (size_t i = 0; i < enemies.size(); i++) {
-            delete enemies[i];
-        }
-        for (size_t i = 0; i < bullets.size(); i++) {
-            delete bullets[i];
-        }
-        for (size_t i = 0; i < enemyBullets.size(); i++) {
-            delete enemyBullets[i];
-        }
-        delete player;
+        simThread.Stop();
+        delete lockstep;
+        delete chunkCache;
+        delete hud;
 
         UnloadTexture(pathTexture);
         UnloadTexture(torchTexture);
@@ -286,434 +220,219 @@ public:
         UnloadTexture(brickBlockCurve5Texture);
         UnloadTexture(brick1);
         UnloadTexture(enemyTexture);
-        UnloadTexture(knightTexture);
-        UnloadTexture(wizardTexture);
-        UnloadTexture(archerTexture);
         UnloadTexture(defenderPath);
         UnloadTexture(bulletTexture);
         UnloadTexture(bigHeartTexture);
         UnloadTexture(fullHeartTexture);
         UnloadTexture(halfHeartTexture);
         UnloadTexture(emptyHeartTexture);
-        UnloadTexture(goblinTexture);
-        UnloadTexture(orcTexture);
-        UnloadMusicStream(backgroundMusic);
-        CloseAudioDevice();
+        for (int t = 0; t < defenderTypeCount; t++) {
+            UnloadTexture(defenderTextures[t]);
+        }
+        for (int t = 0; t < enemyTypeCount; t++) {
+            UnloadTexture(enemyTextures[t]);
+        }
+        audio.Stop();
 
         CloseWindow();
     }
 
     // --------------------------------------------------------------------
-    // Update Enemy: moves enemy along the path
+    // Draw a snapshot's sprites, layer by layer, from the chunks in view
     // --------------------------------------------------------------------
-    void UpdateEnemy(Enemy &enemy, float deltaTime, int totalEnemies) {
-        if (!enemy.isAlive) return;
-
-        if (enemy.currentWaypoint >= (int)enemyPathRC.size()) {
-            enemy.isAlive = false;
-            enemiesReached++;
-            if (enemiesReached >= totalEnemies) {
-                gameOver = true;
+    void DrawSnapshot(const RenderSnapshot &frame, Rectangle view) {
+        if (frame.bins.empty()) return;
+        const TileMap &map = sim.Map();
+        // Sprites can reach a tile past their chunk (hearts hang below)
+        float chunkPx = (float)(chunkSize * tileSize);
+        int c0 = max(0, (int)floorf((view.x - tileSize) / chunkPx));
+        int r0 = max(0, (int)floorf((view.y - tileSize) / chunkPx));
+        int c1 = min(map.ChunkCols() - 1, (int)floorf((view.x + view.width + tileSize) / chunkPx));
+        int r1 = min(map.ChunkRows() - 1, (int)floorf((view.y + view.height + tileSize) / chunkPx));
+        // Bins are in draw order and hold only occupied chunks
+        for (size_t b = 0; b < frame.bins.size(); b++) {
+            const RenderSnapshot::SpriteBin &bin = frame.bins[b];
+            if (bin.chunkRow < r0 || bin.chunkRow > r1 || bin.chunkCol < c0 || bin.chunkCol > c1) continue;
+            for (int i = bin.first; i < bin.end; i++) {
+                const SpriteInstance &s = frame.sprites[i];
+                const SpriteDraw &d = sprites[s.sprite];
+                Vector2 pos = { s.x + d.offset.x, s.y + d.offset.y };
+                DrawTextureEx(d.texture, pos, s.rotation, d.scale, WHITE);
             }
-            return;
-        }
-
-        float targetRow = enemyPathRC[enemy.currentWaypoint].x;
-        float targetCol = enemyPathRC[enemy.currentWaypoint].y;
-        float dRow = targetRow - enemy.row;
-        float dCol = targetCol - enemy.col;
-        float distance = sqrtf(dRow * dRow + dCol * dCol);
-
-        if (distance < 0.1f) {
-            enemy.currentWaypoint++;
-        } else {
-            float invDist = 1.0f / distance;
-            float dirRow = dRow * invDist;
-            float dirCol = dCol * invDist;
-            float move = enemy.speed * deltaTime;
-            enemy.row += dirRow * move;
-            enemy.col += dirCol * move;
         }
     }
 
     // --------------------------------------------------------------------
-    // Draw Enemy
-    // --------------------------------------------------------------------
-    void DrawEnemy(const Enemy &enemy) {
-        if (!enemy.isAlive) return;
-        float x = enemy.col * tileSize;
-        float y = enemy.row * tileSize;
-        DrawTexture(enemy.texture, (int)x, (int)y, WHITE);
-    }
-
-    // --------------------------------------------------------------------
-    // Update Defender: spawn bullet if enemy in range
+    // Camera and Map
     // --------------------------------------------------------------------
-    void UpdateDefender(Defender &def, float deltaTime, vector<Enemy*> &enemiesPtr) {
-        def.attackTimer += deltaTime;
-
-        if (def.attackTimer >= def.attackCooldown) {
-            Enemy* closestEnemy = nullptr;
-            float closestDist = 999999.0f;
-
-            for (size_t i = 0; i < enemiesPtr.size(); i++) {
-                Enemy* e = enemiesPtr[i];
-                if (!e->isAlive) continue;
-                float dRow = e->row - def.row;
-                float dCol = e->col - def.col;
-                float dist = sqrtf(dRow * dRow + dCol * dCol);
-                if (dist < closestDist) {
-                    closestDist = dist;
-                    closestEnemy = e;
-                }
-            }
 
-            if (closestEnemy) {
-                Vector2 defenderCenter = { (def.col + 0.5f) * tileSize, (def.row + 0.5f) * tileSize };
-                Vector2 enemyCenter = { (closestEnemy->col + 0.5f) * tileSize, (closestEnemy->row + 0.5f) * tileSize };
-                Vector2 direction = Vector2Subtract(enemyCenter, defenderCenter);
-                float distance = Vector2Length(direction);
-                if (distance > 0.0f) {
-                    direction = Vector2Scale(direction, 1.0f / distance);
-                }
-                Bullet* newBullet = new Bullet;
-                newBullet->position = defenderCenter;
-                newBullet->velocity = Vector2Scale(direction, 200.0f);
-                newBullet->active = true;
-                bullets.push_back(newBullet);
-            }
-            def.attackTimer = 0.0f;
-        }
+    // World-space rectangle currently on screen
+    Rectangle ViewRect() {
+        Vector2 topLeft = GetScreenToWorld2D({ 0.0f, 0.0f }, camera);
+        return { topLeft.x, topLeft.y, screenWidth / camera.zoom, screenHeight / camera.zoom };
     }
 
-    // --------------------------------------------------------------------
-    // Update Bullets (defender bullets)
-    // --------------------------------------------------------------------
-    void UpdateBullets(float deltaTime, vector<Enemy*> &enemiesPtr, int screenW, int screenH) {
-        for (size_t i = 0; i < bullets.size(); i++) {
-            Bullet* b = bullets[i];
-            if (!b->active) continue;
-            b->position = Vector2Add(b->position, Vector2Scale(b->velocity, deltaTime));
-
-            if (b->position.x < 0 || b->position.x > screenW ||
-                b->position.y < 0 || b->position.y > screenH) {
-                b->active = false;
-                continue;
-            }
-
-            for (size_t j = 0; j < enemiesPtr.size(); j++) {
-                Enemy* e = enemiesPtr[j];
-                if (!e->isAlive) continue;
-                Vector2 enemyCenter = { (e->col + 0.5f) * tileSize, (e->row + 0.5f) * tileSize };
-                float dx = b->position.x - enemyCenter.x;
-                float dy = b->position.y - enemyCenter.y;
-                float distSqr = dx * dx + dy * dy;
-                float collisionRange = 16.0f;
-                if (distSqr < collisionRange * collisionRange) {
-                    e->isAlive = false;
-                    b->active = false;
-                    
-                    player->gold += 50.0f;
-                    break;
-                }
-            }
+    // WASD / arrows or right-drag to scroll, mouse wheel to zoom at the cursor
+    void UpdateCamera(float deltaTime) {
+        float panSpeed = 600.0f / camera.zoom;
+        if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT))  camera.target.x -= panSpeed * deltaTime;
+        if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT)) camera.target.x += panSpeed * deltaTime;
+        if (IsKeyDown(KEY_W) || IsKeyDown(KEY_UP))    camera.target.y -= panSpeed * deltaTime;
+        if (IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN))  camera.target.y += panSpeed * deltaTime;
+        if (IsMouseButtonDown(MOUSE_BUTTON_RIGHT)) {
+            Vector2 delta = GetMouseDelta();
+            camera.target.x -= delta.x / camera.zoom;
+            camera.target.y -= delta.y / camera.zoom;
         }
-        // Remove inactive bullets
-        bullets.erase(remove_if(bullets.begin(), bullets.end(),
-            [](Bullet* b) { 
-                if (!b->active) { 
-                    delete b; 
-                    return true; 
-                } 
-                return false; 
-            }), bullets.end());
-    }
 
-    // --------------------------------------------------------------------
-    // Draw Bullets
-    // --------------------------------------------------------------------
-    void DrawBullets(Texture2D bulletTex) {
-        for (size_t i = 0; i < bullets.size(); i++) {
-            Bullet* b = bullets[i];
-            if (!b->active) continue;
-            float angleDeg = atan2f(b->velocity.y, b->velocity.x) * RAD2DEG;
-            Vector2 drawPos = { b->position.x - bulletTex.width * 0.5f, b->position.y - bulletTex.height * 0.5f };
-            DrawTextureEx(bulletTex, drawPos, angleDeg, 1.0f, WHITE);
+        float wheel = GetMouseWheelMove();
+        if (wheel != 0.0f) {
+            Vector2 mouse = GetMousePosition();
+            Vector2 anchor = GetScreenToWorld2D(mouse, camera);
+            camera.zoom = Clamp(camera.zoom * (1.0f + 0.1f * wheel), minZoom, maxZoom);
+            camera.offset = mouse;
+            camera.target = anchor;
         }
+
+        // Keep the view inside the world (centred if the world is smaller)
+        Rectangle view = ViewRect();
+        float dx = 0.0f, dy = 0.0f;
+        if (view.width >= worldWidth) dx = (worldWidth - view.width) * 0.5f - view.x;
+        else dx = Clamp(view.x, 0.0f, worldWidth - view.width) - view.x;
+        if (view.height >= worldHeight) dy = (worldHeight - view.height) * 0.5f - view.y;
+        else dy = Clamp(view.y, 0.0f, worldHeight - view.height) - view.y;
+        camera.target.x += dx;
+        camera.target.y += dy;
     }
 
-    // --------------------------------------------------------------------
-    // Draw Defenders (with heart health indicator)
-    // --------------------------------------------------------------------
-    void DrawDefenders(const vector<Defender*> &defendersPtr,
-                       Texture2D knightTex,
-                       Texture2D wizardTex,
-                       Texture2D archerTex,
-                       Texture2D bigHeartTex,
-                       Texture2D fullHeartTex,
-                       Texture2D halfHeartTex,
-                       Texture2D emptyHeartTex)
-    {
-        for (size_t i = 0; i < defendersPtr.size(); i++) {
-            Defender* d = defendersPtr[i];
-            float tileX = d->col * tileSize;
-            float tileY = d->row * tileSize;
-
-            float healthRatio = d->currentHealth / d->maxHealth;
-            Texture2D heartToDraw;
-            if (healthRatio >= 1.0f) {
-                heartToDraw = fullHeartTex;
-            } else if (healthRatio >= 0.5f) {
-                heartToDraw = halfHeartTex;
-            } else {
-                heartToDraw = emptyHeartTex;
-            }
-            // Draw the heart one tile below
-            float heartScale = (float)tileSize / heartToDraw.width;
-            Vector2 heartPos = { tileX, tileY + tileSize };
-            DrawTextureEx(heartToDraw, heartPos, 0.0f, heartScale, WHITE);
-
-            Texture2D defTex;
-            switch (d->type) {
-                case DefenderType::KNIGHT: defTex = knightTex; break;
-                case DefenderType::WIZARD: defTex = wizardTex; break;
-                case DefenderType::ARCHER: defTex = archerTex; break;
-            }
-            float defScale = (float)tileSize / (defTex.width * 1.25f);
-            float offsetX = (tileSize - defTex.width * defScale) * 0.5f;
-            float offsetY = tileSize - (defTex.height * defScale);
-            Vector2 defPos = { tileX + offsetX, tileY + offsetY };
-            DrawTextureEx(defTex, defPos, 0.0f, defScale, WHITE);
-        }
+    // Cost box for each defender archetype, stacked down the right-hand side
+    Rectangle CostBox(int type) {
+        return { 610.0f, 150.0f + 100.0f * type, 100.0f, 30.0f };
     }
 
     // --------------------------------------------------------------------
-    // Enemy Bullet Functionality
+    // HUD: laid out once; Sync() redraws it only when gold, enemies left or
+    // game over change. Its widgets are also what clicks are tested against.
     // --------------------------------------------------------------------
-    void UpdateEnemyShooting(float deltaTime, vector<Enemy*> &enemiesPtr, vector<Defender*> &defendersPtr) {
-        const float enemyAttackRange = 5.0f; // Adjust this value as needed
-        for (size_t i = 0; i < enemiesPtr.size(); i++) {
-            Enemy* e = enemiesPtr[i];
-            if (!e->isAlive) continue;
-            if (e->hasActiveBullet) continue;  // Ensures each enemy only has one bullet at a time
-    
-            Defender* target = nullptr;
-            float closestDist = 999999.0f;
-            for (size_t j = 0; j < defendersPtr.size(); j++) {
-                Defender* d = defendersPtr[j];
-                float dRow = d->row - e->row;
-                float dCol = d->col - e->col;
-                float dist = sqrtf(dRow * dRow + dCol * dCol);
-                // Check if the defender is within the enemy's attack range
-                if (dist < enemyAttackRange && dist < closestDist) {
-                    closestDist = dist;
-                    target = d;
-                }
-            }
-            if (target) {
-                Vector2 enemyCenter = { (e->col + 0.5f) * tileSize, (e->row + 0.5f) * tileSize };
-                Vector2 defenderCenter = { (target->col + 0.5f) * tileSize, (target->row + 0.5f) * tileSize };
-                Vector2 direction = Vector2Subtract(defenderCenter, enemyCenter);
-                float distance = Vector2Length(direction);
-                if (distance > 0.0f) {
-                    direction = Vector2Scale(direction, 1.0f / distance);
-                }
-                EnemyBullet* newBullet = new EnemyBullet;
-                newBullet->position = enemyCenter;
-                newBullet->velocity = Vector2Scale(direction, 200.0f);
-                newBullet->active = true;
-                newBullet->owner = e;
-                enemyBullets.push_back(newBullet);
-                e->hasActiveBullet = true;
-            }
-        }
-    }
-    
-
-    void UpdateEnemyBullets(float deltaTime, vector<Defender*> &defendersPtr, int screenW, int screenH) {
-        for (size_t i = 0; i < enemyBullets.size(); i++) {
-            EnemyBullet* b = enemyBullets[i];
-            if (!b->active) continue;
-            b->position = Vector2Add(b->position, Vector2Scale(b->velocity, deltaTime));
-
-            if (b->position.x < 0 || b->position.x > screenW ||
-                b->position.y < 0 || b->position.y > screenH) {
-                if (b->owner)
-                    b->owner->hasActiveBullet = false;
-                b->active = false;
-                continue;
-            }
-            for (size_t j = 0; j < defendersPtr.size(); j++) {
-                Defender* d = defendersPtr[j];
-                Vector2 defCenter = { (d->col + 0.5f) * tileSize, (d->row + 0.5f) * tileSize };
-                float dx = b->position.x - defCenter.x;
-                float dy = b->position.y - defCenter.y;
-                float distSqr = dx * dx + dy * dy;
-                float collisionRange = 16.0f;
-                if (distSqr < collisionRange * collisionRange) {
-                    d->currentHealth -= 50.0f;
-                    if (b->owner)
-                        b->owner->hasActiveBullet = false;
-                    b->active = false;
-                    break;
-                }
-            }
-        }
-        enemyBullets.erase(remove_if(enemyBullets.begin(), enemyBullets.end(),
-            [](EnemyBullet* eb) { 
-                if (!eb->active) { delete eb; return true; }
-                return false;
-            }), enemyBullets.end());
-    }
+    void BuildHud() {
+        hud = new HudLayer(screenWidth, screenHeight);
 
-    void DrawEnemyBullets(Texture2D bulletTex) {
-        for (size_t i = 0; i < enemyBullets.size(); i++) {
-            EnemyBullet* b = enemyBullets[i];
-            if (!b->active) continue;
-            float angleDeg = atan2f(b->velocity.y, b->velocity.x) * RAD2DEG;
-            Vector2 drawPos = { b->position.x - bulletTex.width * 0.5f, b->position.y - bulletTex.height * 0.5f };
-            DrawTextureEx(bulletTex, drawPos, angleDeg, 1.0f, WHITE);
+        // Cost boxes, with the defender standing on top of each
+        float scale = 2.0f;
+        for (int t = 0; t < defenderTypeCount; t++) {
+            Rectangle costBox = CostBox(t);
+            int box = hud->AddBox(costBox, RAYWHITE, BLACK, 2.0f);
+            hud->SetAction(box, InputAction::SELECT_DEFENDER, t);
+            hud->AddText({ costBox.x + 5, costBox.y + 5, 0.0f, 0.0f }, TextAlign::LEFT,
+                         TextFormat("Cost:%i", (int)defenderArchetypes[t].cost), 20, BLACK);
+            Texture2D tex = defenderTextures[t];
+            int texWidth  = (int)(tex.width  * scale);
+            int texHeight = (int)(tex.height * scale);
+            Vector2 texPos = { (float)(int)(costBox.x + (costBox.width - texWidth) / 2), costBox.y - texHeight };
+            hud->AddImage(tex, texPos, scale);
         }
+
+        int gameOver = hud->AddText({ 0.0f, 0.0f, (float)screenWidth, (float)screenHeight }, TextAlign::CENTER,
+                                    "Game Over", 40, RED);
+        hud->Bind(gameOver, HudBinding::GAME_OVER);
+
+        // EXIT button
+        Rectangle exitButton = { (float)(screenWidth - 120 - 98), (float)(screenHeight - 60 - 4), 120.0f, 60.0f };
+        int exitLabel = hud->AddText(exitButton, TextAlign::CENTER, "< EXIT >", 20, BLACK);
+        hud->SetAction(exitLabel, InputAction::EXIT);
+
+        // "X" button for refund
+        Rectangle refundButton = { 100.0f, 450.0f, 60.0f, 60.0f };
+        int refundLabel = hud->AddText(refundButton, TextAlign::CENTER, "X", 40, RED, 90.0f);
+        hud->SetAction(refundLabel, InputAction::REFUND);
+
+        // Money & Enemies label
+        int money = hud->AddText({ 20.0f, 20.0f, 0.0f, 0.0f }, TextAlign::LEFT, "Money: %i", 24, YELLOW);
+        hud->Bind(money, HudBinding::GOLD);
+        int enemiesLabel = hud->AddText({ (float)(screenWidth - 20), 20.0f, 0.0f, 0.0f }, TextAlign::RIGHT,
+                                        "Enemies: %i", 24, YELLOW);
+        hud->Bind(enemiesLabel, HudBinding::ENEMIES_LEFT);
     }
 
     // --------------------------------------------------------------------
-    // Draw Map and Tower Cost Boxes 
+    // Input: UI actions happen here, game actions become commands.
+    // Returns true if EXIT was clicked.
     // --------------------------------------------------------------------
-    void DrawMap(Texture2D pathTexture, Texture2D torchTexture, Texture2D leftColumnTexture,
-                 Texture2D rightColumnTexture, Texture2D wallTopLeftTexture, Texture2D wallTopRightTexture,
-                 Texture2D brickWallTexture, Texture2D bottomWallTexture,
-                 Texture2D bottomLeftBrickTexture, Texture2D bottomRightBrickTexture,
-                 Texture2D bottomWall2Texture, Texture2D brickBlockCurveTexture,
-                 Texture2D brickBlockCurveTexture2, Texture2D doorRightTexture,
-                 Texture2D doorLeftTexture, Texture2D dotBrickTexture, Texture2D dotBrickTexture2,
-                 Texture2D brickBlockCurve3Texture, Texture2D brickBlockCurve4Texture,
-                 Texture2D brickBlockCurve5Texture, Texture2D brick1, Texture2D defenderPath)
-    {
-        for (int rowIdx = 0; rowIdx < rows; rowIdx++) {
-            for (int colIdx = 0; colIdx < cols; colIdx++) {
-                Vector2 pos = { (float)(colIdx * tileSize), (float)(rowIdx * tileSize) };
-                switch (map[rowIdx][colIdx]) {
-                    case 1:
-                        DrawTexture(pathTexture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 2:
-                        DrawTexture(torchTexture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 3:
-                        DrawTexture(leftColumnTexture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 4:
-                        DrawTexture(rightColumnTexture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 5:
-                        DrawTexture(wallTopLeftTexture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 6:
-                        DrawTexture(wallTopRightTexture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 7:
-                        DrawTexture(brickWallTexture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 8:
-                        DrawTexture(bottomWallTexture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 9:
-                        DrawTexture(bottomLeftBrickTexture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 10:
-                        DrawTexture(bottomRightBrickTexture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 11:
-                        DrawTexture(bottomWall2Texture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 12:
-                        DrawTexture(brickBlockCurveTexture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 15:
-                        DrawTexture(brickBlockCurveTexture2, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 16:
-                        DrawTexture(dotBrickTexture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 17:
-                        DrawTexture(dotBrickTexture2, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 13:
-                        DrawTexture(doorRightTexture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 14:
-                        DrawTexture(doorLeftTexture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 18:
-                        DrawTexture(brickBlockCurve3Texture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 19:
-                        DrawTexture(brickBlockCurve4Texture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 20:
-                        DrawTexture(brickBlockCurve5Texture, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 21:
-                        DrawTexture(brick1, (int)pos.x, (int)pos.y, WHITE);
-                        break;
-                    case 22:
-                        DrawTexture(defenderPath, (int)pos.x, (int)pos.y, WHITE);
-                        break;
+    bool HandleInput(const vector<InputHit> &hits) {
+        for (size_t i = 0; i < hits.size(); i++) {
+            const InputHit &hit = hits[i];
+            switch (hit.action) {
+                case InputAction::SELECT_DEFENDER:
+                    selectedDefenderType = (DefenderType)hit.arg;
+                    break;
+                case InputAction::EXIT:
+                    return true;
+                case InputAction::REFUND: {
+                    Command refund = { CommandType::REFUND_ALL, 0, 0, 0, hit.timeNs };
+                    simThread.Send(refund);
+                    break;
                 }
+                case InputAction::PLACE: {
+                    // The simulation checks gold and the lane when it applies this
+                    Command place = { CommandType::PLACE_DEFENDER, (uint8_t)selectedDefenderType,
+                                      hit.row, hit.col, hit.timeNs };
+                    simThread.Send(place);
+                    break;
+                }
+                case InputAction::NONE:
+                    break;
             }
         }
+        return false;
     }
 
-    void DrawTowerCosts(Texture2D knightTexture, Texture2D wizardTexture, Texture2D archerTexture) {
-        int fontSize = 20;
-        float scale = 2.0f;
-        // Knight cost box
-        {
-            Rectangle knightCostBox = {610, 150, 100, 30};
-            DrawRectangleRec(knightCostBox, RAYWHITE);
-            DrawRectangleLinesEx(knightCostBox, 2, BLACK);
-            DrawText("Cost:150", (int)knightCostBox.x + 5, (int)knightCostBox.y + 5, fontSize, BLACK);
-            int knightWidth  = (int)(knightTexture.width  * scale);
-            int knightHeight = (int)(knightTexture.height * scale);
-            int knightX = (int)(knightCostBox.x + (knightCostBox.width - knightWidth) / 2);
-            int knightY = (int)(knightCostBox.y - knightHeight);
-            Vector2 knightPos = {(float)knightX, (float)knightY};
-            DrawTextureEx(knightTexture, knightPos, 0.0f, scale, WHITE);
-        }
-        // Wizard cost box
-        {
-            Rectangle wizardCostBox = {610, 250, 100, 30};
-            DrawRectangleRec(wizardCostBox, RAYWHITE);
-            DrawRectangleLinesEx(wizardCostBox, 2, BLACK);
-            DrawText("Cost:200", (int)wizardCostBox.x + 5, (int)wizardCostBox.y + 5, fontSize, BLACK);
-            int wizardWidth  = (int)(wizardTexture.width  * scale);
-            int wizardHeight = (int)(wizardTexture.height * scale);
-            int wizardX = (int)(wizardCostBox.x + (wizardCostBox.width - wizardWidth) / 2);
-            int wizardY = (int)(wizardCostBox.y - wizardHeight);
-            Vector2 wizardPos = {(float)wizardX, (float)wizardY};
-            DrawTextureEx(wizardTexture, wizardPos, 0.0f, scale, WHITE);
+    // Per-phase timings (moving average / worst) and heap allocations, click latency
+    void DrawProfiler(int x, int y) {
+        const Profiler &prof = sim.Profile();
+        int fontSize = 10;
+        int lineHeight = 12;
+        int lines = profilePhaseCount + 6 + (lockstep ? 2 : 0) + (telemetry.IsOpen() ? 1 : 0);
+        DrawRectangle(x - 4, y - 4, 300, lines * lineHeight + 8, Fade(BLACK, 0.6f));
+        for (int p = 0; p < profilePhaseCount; p++) {
+            const ProfileStat &s = prof.Phase((ProfilePhase)p);
+            DrawText(TextFormat("%-14s %6.3f ms  max %6.3f  %6i new", profilePhaseNames[p],
+                                s.AverageMs(), s.MaxMs(), (int)AllocCount(p)),
+                     x, y + p * lineHeight, fontSize, RAYWHITE);
         }
-        // Archer cost box
-        {
-            Rectangle archerCostBox = {610, 350, 100, 30};
-            DrawRectangleRec(archerCostBox, RAYWHITE);
-            DrawRectangleLinesEx(archerCostBox, 2, BLACK);
-            DrawText("Cost:250", (int)archerCostBox.x + 5, (int)archerCostBox.y + 5, fontSize, BLACK);
-            int archerWidth  = (int)(archerTexture.width  * scale);
-            int archerHeight = (int)(archerTexture.height * scale);
-            int archerX = (int)(archerCostBox.x + (archerCostBox.width - archerWidth) / 2);
-            int archerY = (int)(archerCostBox.y - archerHeight);
-            Vector2 archerPos = {(float)archerX, (float)archerY};
-            DrawTextureEx(archerTexture, archerPos, 0.0f, scale, WHITE);
+        int ly = y + profilePhaseCount * lineHeight;
+        const TickArena &scratch = sim.Scratch();
+        DrawText(TextFormat("heap: %i new, %i KB total; sim tick %i new", (int)AllocCountTotal(),
+                            (int)(AllocBytesTotal() / 1024), simThread.TickAllocs()),
+                 x, ly, fontSize, simThread.TickAllocs() > 0 ? ORANGE : GREEN);
+        DrawText(TextFormat("tick arena %i / %i KB peak, regrown %i", (int)(scratch.Peak() / 1024),
+                            (int)(scratch.Capacity() / 1024), scratch.Regrows()),
+                 x, ly + lineHeight, fontSize, GREEN);
+        ly += 2 * lineHeight;
+        DrawText(TextFormat("click->apply  %6.2f ms  max %6.2f  (n=%i)", prof.clickToApply.LastMs(),
+                            prof.clickToApply.MaxMs(), (int)prof.clickToApply.Count()),
+                 x, ly, fontSize, YELLOW);
+        DrawText(TextFormat("click->frame  %6.2f ms  max %6.2f  (n=%i)", prof.clickToFrame.LastMs(),
+                            prof.clickToFrame.MaxMs(), (int)prof.clickToFrame.Count()),
+                 x, ly + lineHeight, fontSize, YELLOW);
+        DrawText(TextFormat("dropped commands %i  hud redraws %i", simThread.DroppedCommands(), hud->Renders()),
+                 x, ly + 2 * lineHeight, fontSize, YELLOW);
+        DrawText(TextFormat("sfx played %i  coalesced %i  stolen %i  dropped %i", audio.Played(),
+                            audio.Coalesced(), audio.Stolen(), audio.Dropped()),
+                 x, ly + 3 * lineHeight, fontSize, YELLOW);
+        if (lockstep) {
+            DrawText(TextFormat("net p%i  delay %i  %i B/s  sent %i  lost %i", lockstep->Player(),
+                                lockstep->InputDelay(), lockstep->BytesPerSecond(),
+                                lockstep->PacketsSent(), lockstep->PacketsDropped()),
+                     x, ly + 4 * lineHeight, fontSize, SKYBLUE);
+            DrawText(TextFormat("tick %i  stalls %i  cmds dropped %i", (int)lockstep->ConfirmedTick(),
+                                lockstep->Stalls(), lockstep->CommandsDropped()),
+                     x, ly + 5 * lineHeight, fontSize, SKYBLUE);
+            ly += 2 * lineHeight;
         }
-    }
-
-    void RemoveDeadDefenders(vector<Defender*> &defendersPtr) {
-        for (int i = defendersPtr.size() - 1; i >= 0; i--) {
-            if (defendersPtr[i]->currentHealth <= 0.0f) {
-                delete defendersPtr[i];
-                defendersPtr.erase(defendersPtr.begin() + i);
-            }
+        if (telemetry.IsOpen()) {
+            DrawText(TextFormat("telemetry written %i  dropped %i", (int)telemetry.Written(),
+                                (int)telemetry.Dropped()),
+                     x, ly + 4 * lineHeight, fontSize, telemetry.Dropped() > 0 ? ORANGE : GREEN);
         }
     }
 
@@ -721,215 +440,134 @@ public:
     // Main Game Loop
     // --------------------------------------------------------------------
     void Run() {
-        bool exitClicked = false;
-        while (!WindowShouldClose() && !exitClicked) {
+        simThread.Start();
+        while (!WindowShouldClose()) {
             float deltaTime = GetFrameTime();
 
-            // Update background music
-            UpdateMusicStream(backgroundMusic);
-            
-            spawnTimer += deltaTime;
-            // ----------------------------------------------------------------
-            // Spawn enemy using a single spawn timer with random enemy type
-            // ----------------------------------------------------------------
-            if (spawnedEnemiesCount < totalEnemiesToSpawn && spawnTimer >= spawnDelay) {
-                spawnTimer = 0.0f;
-                // Randomly select an enemy type: 0 for Goblin, 1 for Orc
-                int randVal = GetRandomValue(0, 1);
-                EnemyType chosenType = (randVal == 0) ? EnemyType::GOBLIN : EnemyType::ORC;
-                Enemy* newEnemy = new Enemy(chosenType);
-                newEnemy->row = 6.0f;
-                newEnemy->col = 1.0f; // You can adjust the spawn position as needed
-                newEnemy->currentWaypoint = 1;
-                // Set texture based on enemy type
-                if (chosenType == EnemyType::GOBLIN) {
-                    newEnemy->texture = goblinTexture;
-                } else {
-                    newEnemy->texture = orcTexture;
-                }
-                enemies.push_back(newEnemy);
-                spawnedEnemiesCount++;
-            }
-            // 2) Update enemies
-            for (size_t i = 0; i < enemies.size(); i++) {
-                UpdateEnemy(*enemies[i], deltaTime, totalEnemiesToSpawn);
-            }
-            enemies.erase(remove_if(enemies.begin(), enemies.end(),
-                [](Enemy* e) { 
-                    if (!e->isAlive) { delete e; return true; }
-                    return false;
-                }), enemies.end());
-            // 3) Handle clicks (for placing defenders or selecting types)
-            if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-                Vector2 mousePos = GetMousePosition();
-                Rectangle knightCostBox = {610, 150, 100, 30};
-                Rectangle wizardCostBox = {610, 250, 100, 30};
-                Rectangle archerCostBox = {610, 350, 100, 30};
-                if (CheckCollisionPointRec(mousePos, knightCostBox)) {
-                    selectedDefenderType = DefenderType::KNIGHT;
-                } else if (CheckCollisionPointRec(mousePos, wizardCostBox)) {
-                    selectedDefenderType = DefenderType::WIZARD;
-                } else if (CheckCollisionPointRec(mousePos, archerCostBox)) {
-                    selectedDefenderType = DefenderType::ARCHER;
-                } else {
-                    int c = (int)(mousePos.x / tileSize);
-                    int r = (int)(mousePos.y / tileSize);
-                    if (r >= 0 && r < rows && c >= 0 && c < cols) {
-                        if (map[r][c] == 22) { // Defender Path
-                            float costNeeded = 0.0f;
-                            switch (selectedDefenderType) {
-                                case DefenderType::KNIGHT: costNeeded = 150.0f; break;
-                                case DefenderType::WIZARD: costNeeded = 200.0f; break;
-                                case DefenderType::ARCHER: costNeeded = 250.0f; break;
-                            }
-                            if (player->gold >= costNeeded) {
-                                player->gold -= costNeeded;
-                                Defender* newDef = new Defender(costNeeded);
-                                newDef->type = selectedDefenderType;
-                                newDef->row = (float)r;
-                                newDef->col = (float)c;
-                                if (selectedDefenderType == DefenderType::KNIGHT) {
-                                    newDef->maxHealth = 100.0f;
-                                    newDef->currentHealth = 100.0f;
-                                } else if (selectedDefenderType == DefenderType::WIZARD) {
-                                    newDef->maxHealth = 100.0f;
-                                    newDef->currentHealth = 100.0f;
-                                } else if (selectedDefenderType == DefenderType::ARCHER) {
-                                    newDef->maxHealth = 100.0f;
-                                    newDef->currentHealth = 100.0f;
-                                }
-                                defenders.push_back(newDef);
-                            }
-                        }
-                    }
-                }
-            }
-            // 4) Update defenders (each may spawn a bullet)
-            for (size_t i = 0; i < defenders.size(); i++) {
-                UpdateDefender(*defenders[i], deltaTime, enemies);
+            // Clicks are resolved once, against the view that was on screen,
+            // and reach the simulation on its next tick
+            bool exitClicked = false;
+            {
+                ProfileScope scope(sim.Profile(), PHASE_INPUT);
+                if (IsKeyPressed(KEY_F3)) showProfiler = !showProfiler;
+                exitClicked = HandleInput(input.Capture(camera, *hud));
             }
-            // 5) Update enemy shooting (one bullet per enemy)
-            UpdateEnemyShooting(deltaTime, enemies, defenders);
-            // 6) Update defender bullets
-            UpdateBullets(deltaTime, enemies, screenWidth, screenHeight);
-            // 7) Update enemy bullets
-            UpdateEnemyBullets(deltaTime, defenders, screenWidth, screenHeight);
-
-            RemoveDeadDefenders(defenders);
-            
-
-            BeginDrawing();
-            ClearBackground(DARKPURPLE);
+            if (exitClicked) break;
 
-            DrawMap(pathTexture, torchTexture, leftColumnTexture, rightColumnTexture,
-                    wallTopLeftTexture, wallTopRightTexture, brickWallTexture, bottomWallTexture,
-                    bottomLeftBrickTexture, bottomRightBrickTexture, bottomWall2Texture,
-                    brickBlockCurveTexture, brickBlockCurveTexture2, doorRightTexture, doorLeftTexture,
-                    dotBrickTexture, dotBrickTexture2, brickBlockCurve3Texture, brickBlockCurve4Texture,
-                    brickBlockCurve5Texture, brick1, defenderPath);
+            UpdateCamera(deltaTime);
 
-            DrawTowerCosts(knightTexture, wizardTexture, archerTexture);
-
-            for (size_t i = 0; i < enemies.size(); i++) {
-                DrawEnemy(*enemies[i]);
-            }
-            DrawDefenders(defenders, knightTexture, wizardTexture, archerTexture,
-                         bigHeartTexture, fullHeartTexture, halfHeartTexture, emptyHeartTexture);
-            DrawBullets(bulletTexture);
-            DrawEnemyBullets(bulletTexture);
-
-            if (gameOver) {
-                const char* gameOverText = "Game Over";
-                int fontSize = 40;
-                int textWidth = MeasureText(gameOverText, fontSize);
-                int textX = (screenWidth / 2) - (textWidth / 2);
-                int textY = (screenHeight / 2) - (fontSize / 2);
-                DrawText(gameOverText, textX, textY, fontSize, RED);
-            }
-
-            // EXIT button
-            {
-                int buttonWidth = 120;
-                int buttonHeight = 60;
-                int buttonX = screenWidth - buttonWidth - 98;
-                int buttonY = screenHeight - buttonHeight - 4;
-                const char* exitText = "< EXIT >";
-                int exitFontSize = 20;
-                int exitTextWidth = MeasureText(exitText, exitFontSize);
-                DrawText(exitText,
-                         buttonX + (buttonWidth - exitTextWidth) / 2,
-                         buttonY + (buttonHeight - exitFontSize) / 2,
-                         exitFontSize, BLACK);
-                if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-                    Vector2 mousePos = GetMousePosition();
-                    if (mousePos.x > buttonX && mousePos.x < buttonX + buttonWidth &&
-                        mousePos.y > buttonY && mousePos.y < buttonY + buttonHeight)
-                    {
-                        exitClicked = true;
-                    }
-                }
+            // Newest state from the simulation thread
+            const RenderSnapshot &frame = simThread.Latest();
+            if (frame.placedAt != lastPlacedAt) {
+                lastPlacedAt = frame.placedAt;
+                sim.Profile().clickToFrame.Record(ProfileNow() - frame.placedAt);
             }
 
-            // "X" button for refund
-            {
-                int xButtonWidth = 60;
-                int xButtonHeight = 60;
-                int xButtonX = 100;
-                int xButtonY = 450;
-                const char* xText = "X";
-                int xFontSize = 40;
-                int xTextWidth = MeasureText(xText, xFontSize);
-                float textX = xButtonX + (xButtonWidth - xTextWidth) / 2.0f;
-                float textY = xButtonY + (xButtonHeight - xFontSize) / 2.0f;
-                DrawTextPro(GetFontDefault(), xText,
-                            (Vector2){ textX + xTextWidth / 2.0f, textY + xFontSize / 2.0f },
-                            (Vector2){ xTextWidth / 2.0f, xFontSize / 2.0f },
-                            90.0f, (float)xFontSize, 1.0f, RED);
-                if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-                    Vector2 mousePos = GetMousePosition();
-                    if (mousePos.x > xButtonX && mousePos.x < xButtonX + xButtonWidth &&
-                        mousePos.y > xButtonY && mousePos.y < xButtonY + xButtonHeight)
-                    {
-                        float totalRefund = DeleteAllDefenders(defenders);
-                        player->gold += totalRefund;
-                    }
-                }
-            }
+            int64_t drawStart = ProfileNow();
+            BeginDrawing();
+            ClearBackground(DARKPURPLE);
 
-            // Money & Enemies label
-            {
-                int fontSize = 24;
-                Color textColor = YELLOW;
-                DrawText(TextFormat("Money: %i", (int)player->gold), 20, 20, fontSize, textColor);
-                int enemiesLeft = (totalEnemiesToSpawn - spawnedEnemiesCount) + (int)enemies.size();
-                int enemiesLabelWidth = MeasureText(TextFormat("Enemies: %i", enemiesLeft), fontSize);
-                int posX = screenWidth - enemiesLabelWidth - 20;
-                int posY = 20;
-                DrawText(TextFormat("Enemies: %i", enemiesLeft), posX, posY, fontSize, textColor);
+            // World: only chunks and entities inside the view are drawn
+            Rectangle view = ViewRect();
+            chunkCache->Prepare(view, tileTextures);
+            BeginMode2D(camera);
+            chunkCache->Draw();
+            DrawSnapshot(frame, view);
+            EndMode2D();
+
+            // Screen-space HUD (cached; re-rendered only when a value changed)
+            HudValues values = { frame.gold, frame.enemiesLeft, frame.gameOver };
+            hud->Sync(values);
+            hud->Draw();
+
+            if (showProfiler) DrawProfiler(20, 60);
+            if (lockstep && lockstep->DesyncTick() >= 0) {
+                DrawText(TextFormat("DESYNC at tick %i", (int)lockstep->DesyncTick()),
+                         screenWidth / 2 - 90, 20, 20, RED);
+            } else if (lockstep && !lockstep->PeerHeard()) {
+                DrawText("WAITING FOR PEER", screenWidth / 2 - 90, 20, 20, YELLOW);
             }
+            // Timed before EndDrawing(), which also waits out the frame
+            sim.Profile().Record(PHASE_DRAW, ProfileNow() - drawStart);
             EndDrawing();
         }
-    }
-
-    // --------------------------------------------------------------------
-    // Delete All Defenders: remove all defenders and return total refund
-    // --------------------------------------------------------------------
-    float DeleteAllDefenders(vector<Defender*> &defendersPtr) {
-        float totalRefund = 0.0f;
-        for (size_t i = 0; i < defendersPtr.size(); i++) {
-            totalRefund += defendersPtr[i]->cost;
-            delete defendersPtr[i];
-        }
-        defendersPtr.clear();
-        return totalRefund;
+        simThread.Stop();
     }
 };
 
 // --------------------------------------------------------------------
 // main()
 // --------------------------------------------------------------------
-int main() {
-    TowerDefenseGame game;
+// Optional arguments: rooms down and across, e.g. "main 63 46" for a
+// 1008 x 1012 tile map (the largest the fixed-point build holds), then any of
+//   --seed n                  fixed random seed (single player uses the clock)
+//   --net localPort host port player
+//                             lockstep with the instance at host:port; player is 0 or 1
+//   --delay ticks             input delay (default 8)
+//   --loss rate --latency ms --jitter ms
+//                             simulated outgoing packet loss and delay
+//   --telemetry file          stream per-tick metrics to 'file' (read it with telemetry_csv)
+// Two instances on one machine:
+//   main --net 7777 127.0.0.1 7778 0
+//   main --net 7778 127.0.0.1 7777 1
+int main(int argc, char** argv) {
+    int roomsDown = 1, roomsAcross = 1;
+    int first = 1;
+    if (argc > 2 && argv[1][0] != '-') {
+        roomsDown = max(1, atoi(argv[1]));
+        roomsAcross = max(1, atoi(argv[2]));
+        if (roomsDown > maxRoomsDown || roomsAcross > maxRoomsAcross) {
+            TraceLog(LOG_WARNING, "MAP: %i x %i rooms is too large, using at most %i x %i",
+                     roomsDown, roomsAcross, maxRoomsDown, maxRoomsAcross);
+            roomsDown = min(roomsDown, maxRoomsDown);
+            roomsAcross = min(roomsAcross, maxRoomsAcross);
+        }
+        first = 3;
+    }
+
+    LockstepConfig net;
+    bool networked = false, seeded = false;
+    uint32_t seed = 1;
+    const char* telemetryPath = nullptr;
+    for (int i = first; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--seed" && hasValue) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            seeded = true;
+        } else if (arg == "--net" && i + 4 < argc) {
+            net.localPort = (uint16_t)atoi(argv[++i]);
+            net.remoteHost = argv[++i];
+            net.remotePort = (uint16_t)atoi(argv[++i]);
+            net.player = atoi(argv[++i]) != 0 ? 1 : 0;
+            networked = true;
+        } else if (arg == "--delay" && hasValue) {
+            net.inputDelay = max(1, min(atoi(argv[++i]), 120));
+        } else if (arg == "--loss" && hasValue) {
+            net.lossRate = (float)atof(argv[++i]);
+        } else if (arg == "--latency" && hasValue) {
+            net.latencyMs = atoi(argv[++i]);
+        } else if (arg == "--jitter" && hasValue) {
+            net.jitterMs = atoi(argv[++i]);
+        } else if (arg == "--telemetry" && hasValue) {
+            telemetryPath = argv[++i];
+        }
+    }
+    // Both peers must start from the same seed
+    if (!seeded && !networked) seed = (uint32_t)time(nullptr);
+
+    // Without a socket the game would wait for its peer forever, so stop here
+    Lockstep* link = nullptr;
+    if (networked) {
+        link = new Lockstep(net);
+        if (!link->Connected()) {
+            TraceLog(LOG_ERROR, "LOCKSTEP: network unavailable, exiting");
+            delete link;
+            return 1;
+        }
+    }
+
+    TowerDefenseGame game(roomsDown, roomsAcross, seed, link, telemetryPath);
     game.Run();
     return 0;
 }
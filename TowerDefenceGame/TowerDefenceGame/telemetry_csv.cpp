@@ -0,0 +1,88 @@
+// ------------------------------------------------------------------------
+// Telemetry reader: converts the ring written by "main --telemetry file"
+// into CSV on stdout
+//
+// Records are consumed as they are read, which frees their slots for the
+// game. Without --follow the tool drains what is there and exits; with
+// it, it keeps polling until the game closes the file and the ring is
+// empty. Records the game had to drop because the ring was full are
+// reported on stderr (and counted in the overruns column).
+//
+//   telemetry_csv file [--follow]
+// ------------------------------------------------------------------------
+#include "Telemetry.h"
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+static bool ValidHeader(const MappedFile &file) {
+    if (file.Size() < sizeof(TelemetryHeader)) return false;
+    const TelemetryHeader* header = (const TelemetryHeader*)file.Data();
+    return header->magic == telemetryMagic && header->version == telemetryVersion &&
+           header->recordSize == sizeof(TelemetryRecord) && header->phaseCount == profilePhaseCount &&
+           header->capacity > 0 &&
+           file.Size() >= sizeof(TelemetryHeader) + (size_t)header->capacity * sizeof(TelemetryRecord);
+}
+
+static void PrintRecord(const TelemetryRecord &r) {
+    printf("%llu,%lld,%d,%d,%d,%d,%d,%.1f,%d,%u", (unsigned long long)r.tick, (long long)r.timeNs,
+           r.gold, r.enemiesReached, r.enemiesAlive, r.projectilesAlive, r.defendersAlive,
+           r.defenderHealth, r.heapAllocs, r.overruns);
+    for (int p = 0; p < profilePhaseCount; p++) printf(",%u", r.phaseNs[p]);
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: telemetry_csv file [--follow]\n");
+        return 1;
+    }
+    bool follow = argc > 2 && strcmp(argv[2], "--follow") == 0;
+
+    MappedFile file;
+    if (!file.OpenExisting(argv[1])) {
+        fprintf(stderr, "telemetry_csv: cannot open %s\n", argv[1]);
+        return 1;
+    }
+    if (!ValidHeader(file)) {
+        fprintf(stderr, "telemetry_csv: %s is not a telemetry file from this build\n", argv[1]);
+        return 1;
+    }
+    TelemetryHeader* header = (TelemetryHeader*)file.Data();
+    const TelemetryRecord* records = TelemetryRecords(header);
+
+    printf("tick,time_ns,gold,enemies_reached,enemies_alive,projectiles_alive,defenders_alive,"
+           "defender_health,heap_allocs,overruns");
+    for (int p = 0; p < profilePhaseCount; p++) {
+        // Column names without spaces ("enemy shots" -> enemy_shots_ns)
+        printf(",");
+        for (const char* c = profilePhaseNames[p]; *c; c++) putchar(*c == ' ' ? '_' : *c);
+        printf("_ns");
+    }
+    printf("\n");
+
+    uint64_t reportedDrops = 0;
+    while (true) {
+        // Read 'closed' first so records published before it are not missed
+        bool closed = header->closed.load(memory_order_acquire) != 0;
+        uint64_t consumed = header->consumed.load(memory_order_relaxed);
+        uint64_t written = header->written.load(memory_order_acquire);
+        for (; consumed < written; consumed++) {
+            PrintRecord(records[consumed % header->capacity]);
+            header->consumed.store(consumed + 1, memory_order_release);
+        }
+        uint64_t dropped = header->dropped.load(memory_order_relaxed);
+        if (dropped > reportedDrops) {
+            fprintf(stderr, "telemetry_csv: %llu records dropped (ring full), %llu in total\n",
+                    (unsigned long long)(dropped - reportedDrops), (unsigned long long)dropped);
+            reportedDrops = dropped;
+        }
+        if (!follow || closed) break;
+        fflush(stdout);
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    return 0;
+}